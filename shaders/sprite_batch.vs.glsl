@@ -0,0 +1,27 @@
+#version 330
+
+// Input attributes, the sprite quad
+layout(location = 0) in vec3 in_position;
+layout(location = 1) in vec2 in_texcoord;
+
+// Input attributes of every sprite instance
+layout(location = 2) in mat3 in_transform; // takes locations 2 to 4
+layout(location = 5) in vec4 in_texcoords; // minimum (xy) and maximum (zw) texture coordinates of the sprite
+layout(location = 6) in vec3 in_color;
+layout(location = 7) in float in_damage;
+
+// Passed to fragment shader
+out vec2 texcoord;
+flat out vec3 vcolor;
+
+// Application data
+uniform mat3 projection;
+
+void main()
+{
+	texcoord = mix(in_texcoords.xy, in_texcoords.zw, in_texcoord);
+	// Interpolate between the original color and red based on damage intensity
+	vcolor = mix(in_color, vec3(1.0, 0.0, 0.0), in_damage);
+	vec3 pos = projection * in_transform * vec3(in_position.xy, 1.0);
+	gl_Position = vec4(pos.xy, in_position.z, 1.0);
+}
@@ -0,0 +1,179 @@
+// internal
+#include "ai_system/ai_params.hpp"
+
+// stlib
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+AIParams ai_params[ai_type_count];
+
+static const char* type_names[ai_type_count] = { "melee", "ranged", "turret", "shotgun", "rocket", "flamethrower" };
+
+struct ParamField
+{
+	const char* name;
+	float AIParams::* field;
+};
+
+static const ParamField param_fields[] = {
+	{ "maxTurnSpeed", &AIParams::maxTurnSpeed },
+	{ "turnSpeed", &AIParams::turnSpeed },
+	{ "viewThreshold", &AIParams::viewThreshold },
+	{ "lookOffset", &AIParams::lookOffset },
+	{ "shootingRange", &AIParams::shootingRange },
+	{ "shotInterval", &AIParams::shotInterval },
+	{ "separationForce", &AIParams::separationForce },
+	{ "separationWeight", &AIParams::separationWeight },
+	{ "friendlyAvoidanceDistance", &AIParams::friendlyAvoidanceDistance },
+	{ "obstacleAvoidanceDistance", &AIParams::obstacleAvoidanceDistance },
+	{ "projectileAvoidanceDistance", &AIParams::projectileAvoidanceDistance },
+	{ "playerAvoidanceDistance", &AIParams::playerAvoidanceDistance },
+	{ "alignmentForce", &AIParams::alignmentForce },
+	{ "alignmentWeight", &AIParams::alignmentWeight },
+	{ "alignmentDistance", &AIParams::alignmentDistance },
+	{ "cohesionForce", &AIParams::cohesionForce },
+	{ "cohesionWeight", &AIParams::cohesionWeight },
+	{ "cohesionDistance", &AIParams::cohesionDistance },
+	{ "playerFollowDistance", &AIParams::playerFollowDistance },
+	{ "maxSpeed", &AIParams::maxSpeed },
+	{ "forceWeight", &AIParams::forceWeight },
+};
+
+// The shooters share most of their steering, they keep their distance from each other and the player
+static AIParams shooter_defaults()
+{
+	AIParams p;
+	p.maxTurnSpeed = 3.f;
+	p.turnSpeed = 0.1f;
+	p.viewThreshold = .5f;
+	p.separationForce = 1.f;
+	p.separationWeight = 1.f;
+	p.friendlyAvoidanceDistance = 150.f;
+	p.obstacleAvoidanceDistance = 50.f;
+	p.projectileAvoidanceDistance = 150.f;
+	p.playerAvoidanceDistance = 50.f;
+	p.alignmentForce = 1.f;
+	p.alignmentWeight = .5f;
+	p.alignmentDistance = 200.f;
+	p.cohesionForce = 1.f;
+	p.cohesionWeight = .5f;
+	p.cohesionDistance = 200.f;
+	p.playerFollowDistance = 300.f;
+	p.maxSpeed = 200.f;
+	p.forceWeight = 0.01f;
+	return p;
+}
+
+static AIParams default_params(AI::AIType type)
+{
+	AIParams p = shooter_defaults();
+	switch (type) {
+	case AI::AIType::MELEE:
+		// rushes the player and does not shoot
+		p.lookOffset = M_PI / 2;
+		p.separationWeight = .5f;
+		p.playerAvoidanceDistance = 0.f;
+		p.cohesionForce = 10.f;
+		p.cohesionWeight = 10.5f;
+		p.cohesionDistance = 0.f;
+		p.playerFollowDistance = 0.f;
+		p.forceWeight = 1.f;
+		break;
+	case AI::AIType::RANGED:
+		p.lookOffset = -M_PI / 2;
+		p.shootingRange = 500.f;
+		p.shotInterval = 1.f;
+		p.playerAvoidanceDistance = 200.f;
+		break;
+	case AI::AIType::TURRET:
+		// does not move, shoots at any range
+		p = AIParams();
+		p.maxTurnSpeed = 2.f;
+		p.turnSpeed = 2.f;
+		p.viewThreshold = .5f;
+		p.lookOffset = M_PI / 2;
+		p.shotInterval = .5f;
+		break;
+	case AI::AIType::SHOTGUN:
+		p.lookOffset = -M_PI / 2;
+		p.shootingRange = 250.f;
+		p.shotInterval = 1.5f;
+		p.playerFollowDistance = 100.f;
+		p.maxSpeed = 250.f;
+		break;
+	case AI::AIType::ROCKET:
+		p.lookOffset = M_PI / 2;
+		p.shootingRange = 500.f;
+		p.shotInterval = 1.5f;
+		p.separationWeight = 1.5f;
+		p.obstacleAvoidanceDistance = 100.f;
+		p.projectileAvoidanceDistance = 250.f;
+		p.maxSpeed = 50.f;
+		break;
+	case AI::AIType::FLAMETHROWER:
+		// the flame sprite needs another quarter turn
+		p.lookOffset = -3 * M_PI / 4;
+		p.shootingRange = 250.f;
+		p.shotInterval = 0.05f;
+		p.obstacleAvoidanceDistance = 100.f;
+		p.projectileAvoidanceDistance = 250.f;
+		p.alignmentDistance = 50.f;
+		p.cohesionDistance = 50.f;
+		p.maxSpeed = 150.f;
+		break;
+	}
+	return p;
+}
+
+// the table holds the defaults before anything is loaded
+static bool init_defaults()
+{
+	for (int i = 0; i < ai_type_count; i++)
+		ai_params[i] = default_params((AI::AIType)i);
+	return true;
+}
+static bool defaults_initialized = init_defaults();
+
+bool load_ai_params(const std::string& path)
+{
+	init_defaults();
+
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		std::cerr << "Could not open " << path << ", using the default AI parameters" << std::endl;
+		return false;
+	}
+
+	int type = -1;
+	std::string line;
+	for (int line_number = 1; std::getline(file, line); line_number++) {
+		line = line.substr(0, line.find('#'));
+		std::istringstream in(line);
+		std::string name;
+		if (!(in >> name))
+			continue;
+
+		if (name.front() == '[') {
+			type = -1;
+			for (int i = 0; i < ai_type_count; i++)
+				if (name == "[" + std::string(type_names[i]) + "]")
+					type = i;
+			if (type < 0)
+				std::cerr << path << ":" << line_number << ": unknown AI type " << name << std::endl;
+			continue;
+		}
+
+		float value;
+		const ParamField* field = nullptr;
+		for (const ParamField& f : param_fields)
+			if (name == f.name)
+				field = &f;
+		if (type < 0 || !field || !(in >> value)) {
+			std::cerr << path << ":" << line_number << ": ignored '" << line << "'" << std::endl;
+			continue;
+		}
+		ai_params[type].*(field->field) = value;
+	}
+	return true;
+}
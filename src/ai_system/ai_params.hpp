@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+
+#include "common/common.hpp"
+#include "components/components.hpp"
+
+// Tuning of one enemy type, read by the AI handlers instead of per-call locals
+struct AIParams
+{
+	// turning towards the player (see rotateTowardsPlayer)
+	float maxTurnSpeed = 0.f; // Maximum turn speed
+	float turnSpeed = 0.f; // Turn acceleration
+	float viewThreshold = 0.f; // Threshold for angle difference that determines when it is facing the player
+	float lookOffset = 0.f; // angle between the sprite and the direction it looks at
+
+	// shooting
+	float shootingRange = 0.f; // Distance to shoot at the player
+	float shotInterval = 0.f; // seconds between shots
+
+	// boids steering (see AISystem::steerBoids)
+	float separationForce = 0.f; // base separation force
+	float separationWeight = 0.f; // separation weight when combined with other forces
+	float friendlyAvoidanceDistance = 0.f; // Distance to avoid other entities
+	float obstacleAvoidanceDistance = 0.f; // Distance to avoid obstacles
+	float projectileAvoidanceDistance = 0.f; // Distance to avoid projectiles
+	float playerAvoidanceDistance = 0.f; // Distance to avoid player
+	float alignmentForce = 0.f; // base alignment force
+	float alignmentWeight = 0.f; // alignment weight when combined with other forces
+	float alignmentDistance = 0.f; // Distance to consider for alignment
+	float cohesionForce = 0.f; // base cohesion force
+	float cohesionWeight = 0.f; // cohesion weight when combined with other forces
+	float cohesionDistance = 0.f; // Distance to consider for cohesion
+	float playerFollowDistance = 0.f; // Distance to follow the player
+	float maxSpeed = 0.f; // 0 for enemies that do not move
+	float forceWeight = 0.f; // Overall weight for steering force
+};
+
+const int ai_type_count = (int)AI::AIType::FLAMETHROWER + 1;
+
+// Parameters of every AI::AIType, indexed by the type.
+// They start as the built-in defaults and are replaced by whatever ai_params.txt sets.
+extern AIParams ai_params[ai_type_count];
+
+inline const AIParams& params_of(AI::AIType type) { return ai_params[(int)type]; }
+
+inline std::string ai_params_path() { return data_path() + "/ai_params.txt"; }
+
+// Resets the table to the defaults and applies the file on top, false if it could not be read.
+// The file has a [type] line (melee, ranged, turret, shotgun, rocket, flamethrower) before
+// 'name value' lines with the field names of AIParams, # starts a comment.
+bool load_ai_params(const std::string& path);
@@ -3,11 +3,13 @@
 #include <world_system/world_system.hpp>
 #include <world_init/world_init.hpp>
 #include <components/components.hpp>
-#include <queue> // For priority queue (open list)
+#include <profiler/profiler.hpp>
+#include <job_system/job_system.hpp>
 #include <unordered_set>  
 #include <algorithm> 
 #include <vector>
 #include <cmath>
+#include <climits>
 #include <memory>
 #include <map>
 #include <iostream>
@@ -26,207 +28,251 @@ const float yMin = 32.0f;
 const float xMax = 1440.0f;
 const float yMax = 992.0f;
 const float halfCellSize = cellSize / 2.0f;
+// AIs per job of the parallel parts of the step, smaller rooms run on the calling thread only
+const unsigned int aiBatchSize = 32;
 
-struct Vec2Hash {
-    std::size_t operator()(const vec2& v) const {
-        return std::hash<float>()(v.x) ^ std::hash<float>()(v.y);
-    }
-};
-
-vec2 AISystem::clampPositionToBounds(const vec2& position) {
-    float clampedX = std::max(xMin + (cellSize + halfCellSize), std::min(position.x, xMax - (cellSize + halfCellSize)));
-    float clampedY = std::max(yMin + (cellSize + halfCellSize), std::min(position.y, yMax - (cellSize + halfCellSize)));
-    return vec2(clampedX, clampedY);
+// Convert a position from world coordinates to grid coordinates
+static ivec2 toGridCoord(const vec2& pos) {
+    return ivec2(floor((pos.x - xMin) / cellSize), floor((pos.y - yMin) / cellSize));
 }
 
 // http://www.cse.yorku.ca/~amana/research/grid.pdf
  // Amanatides, J., & Woo, A. (1987). A fast voxel traversal algorithm for ray tracing. Eurographics, 87(3), 3-10.
- // This is a simple implementation of the Bresenham's line algorithm
+ // Bresenham's line over the room grid, the room precomputes it for every pair of cells (see Room::build_occupancy)
 bool AISystem::lineOfSightClear(const vec2& start, const vec2& end) {
-    // Convert start and end positions from world coordinates to grid coordinates
-    auto toGridCoord = [&](const vec2& pos) -> vec2 {
-        return vec2(floor((pos.x - xMin) / cellSize), floor((pos.y - yMin) / cellSize));
-        };
-
-    vec2 startGrid = toGridCoord(start);
-    vec2 endGrid = toGridCoord(end);
-
-    // Bresenham's Line Algorithm variables
-    int dx = abs(int(endGrid.x - startGrid.x));
-    int sx = startGrid.x < endGrid.x ? 1 : -1;
-    int dy = -abs(int(endGrid.y - startGrid.y));
-    int sy = startGrid.y < endGrid.y ? 1 : -1;
-    int err = dx + dy; // error value e_xy
-    int e2; 
-
-    while (true) {
-        // Check for obstacle at current grid position
-        if (isObstacleAtPosition(vec2(startGrid.x, startGrid.y))) {
-            return false; // Obstacle found, line of sight is not clear
-        }
-        if (startGrid.x == endGrid.x && startGrid.y == endGrid.y) break; // Reached target cell
-
-        e2 = 2 * err;
-        if (e2 >= dy) { // e_xy+e_x > 0
-            err += dy;
-            startGrid.x += sx;
-        }
-        if (e2 <= dx) { // e_xy+e_y < 0
-            err += dx;
-            startGrid.y += sy;
-        }
-    }
-
-    return true; // No obstacles found, line of sight is clear
+    return currentRoom().line_of_sight(toGridCoord(start), toGridCoord(end));
 }
 
 
-// Adjusted obstacle detection to consider the full bounding box of obstacles
-bool AISystem::isObstacleAtPosition(const vec2& gridPosition) {
+const Room& AISystem::currentRoom() {
     Level& level = registry.levels.get(registry.levels.entities[0]);
-    Room& room = registry.rooms.get(level.rooms[level.current_room]);
+    return registry.rooms.get(level.rooms[level.current_room]);
+}
 
-    for (const auto& obstaclePos : room.obstacle_positions) {
-        // Direct comparison, as both are in grid coordinates
-        if (obstaclePos == gridPosition) {
-            return true; // Obstacle found at the specified grid position
-        }
-    }
 
-    return false; // No obstacle at the specified grid position
+// Center of the next cell of the shared flow field towards the player
+vec2 AISystem::flowFieldWaypoint(const vec2& position, const vec2& playerPosition) {
+    ivec2 cell = toGridCoord(position);
+    ivec2 next = player_flow.next_cell(cell);
+    if (next == cell) {
+        return playerPosition; // the player cannot be reached from here
+    }
+    return vec2(xMin + next.x * cellSize + halfCellSize, yMin + next.y * cellSize + halfCellSize);
 }
 
+// Shooters that lost sight of the player head for the closest cell that sees it rather than for the player,
+// a goal of their own that the shared flow field cannot give them, so they find their way with A*
+vec2 AISystem::firingCellWaypoint(const vec2& position, const vec2& playerPosition) {
+    const Room& room = currentRoom();
+    ivec2 cell = toGridCoord(position);
+    ivec2 goal = cell;
+    int bestDistance = INT_MAX;
+    for (int y = 0; y < room_grid_size; y++) {
+        for (int x = 0; x < room_grid_size; x++) {
+            ivec2 candidate = { x, y };
+            int distance = (x - cell.x) * (x - cell.x) + (y - cell.y) * (y - cell.y);
+            if (distance < bestDistance && !room.is_obstacle(candidate) && player_visibility.visible_from(candidate)) {
+                goal = candidate;
+                bestDistance = distance;
+            }
+        }
+    }
 
-// Basic structure for A* nodes
-struct AStarNode {
-    vec2 position;
-    float gCost; // Cost from start to this node
-    float hCost; // Heuristic cost to goal
-    float fCost() const { return gCost + hCost; } // Total cost
-    AStarNode* parent; // For reconstructing the path
-};
-
-struct CompareAStarNode {
-    bool operator()(AStarNode* a, AStarNode* b) const {
-        return a->fCost() > b->fCost();
-    }
-};
-std::vector<vec2> AISystem::generateNeighbors(const vec2& position) {
-    std::vector<vec2> neighbors;
-    //generate neighbors in four directions
-    float stepSize = 10.0; // adjust as necessary
-    neighbors.push_back(position + vec2(stepSize, 0)); // Right
-    neighbors.push_back(position + vec2(-stepSize, 0)); // Left
-    neighbors.push_back(position + vec2(0, stepSize)); // Up
-    neighbors.push_back(position + vec2(0, -stepSize)); // Down
-    neighbors.push_back(position + vec2(stepSize, stepSize)); // Up-right
-    neighbors.push_back(position + vec2(-stepSize, stepSize)); // Up-left
-    neighbors.push_back(position + vec2(stepSize, -stepSize)); // Down-right
-    neighbors.push_back(position + vec2(-stepSize, -stepSize)); // Down-left
-
-    return neighbors;
+    std::vector<vec2> path = findPathAStar(position, vec2(xMin + goal.x * cellSize + halfCellSize, yMin + goal.y * cellSize + halfCellSize));
+    if (path.size() < 2) {
+        return flowFieldWaypoint(position, playerPosition); // no firing cell can be reached from here
+    }
+    return path[1];
 }
 
-
+// Path through the room grid from the cell of start to the cell of goal, as the centers of the cells on the way
 std::vector<vec2> AISystem::findPathAStar(const vec2& start, const vec2& goal) {
-    auto heuristic = [](const vec2& a, const vec2& b) -> float {
-        // Use Euclidean distance as the heuristic
-        return length(a - b);
-        };
-
-    std::priority_queue<AStarNode*, std::vector<AStarNode*>, CompareAStarNode> openSet;
-    std::unordered_map<vec2, AStarNode*, Vec2Hash> allNodes;
     std::vector<vec2> path;
+    for (const ivec2& cell : pathfinder.find_path(currentRoom(), toGridCoord(start), toGridCoord(goal))) {
+        path.push_back(vec2(xMin + cell.x * cellSize + halfCellSize, yMin + cell.y * cellSize + halfCellSize));
+    }
+    return path;
+}
 
-    AStarNode* startNode = new AStarNode{ start, 0, heuristic(start, goal), nullptr };
-    openSet.push(startNode);
-    allNodes[start] = startNode;
+void AISystem::step(float elapsed_ms)
+{
+    PROFILE_SCOPE("ai.step");
+    buildNeighborGrids();
+    if (registry.players.size() > 0) {
+        const vec2& playerPosition = registry.motions.get(registry.players.entities[0]).position;
+        player_flow.update(currentRoom(), toGridCoord(playerPosition));
+        updateSight(playerPosition);
+    }
+    think();
+    if (registry.players.size() > 0) {
+        steerBoids(registry.motions.get(registry.players.entities[0]).position);
+    }
+
+    // Every AI only turns itself and counts down its own cooldown, reading the player and the results
+    // of think and steerBoids. The shots are queued per thread and created after all jobs are done.
+    {
+        PROFILE_SCOPE("ai.act");
+        shot_queues.resize(jobs.thread_count());
+        auto& ai_registry = registry.ais;
+        jobs.parallel_for(ai_registry.size(), aiBatchSize, [&](unsigned int begin, unsigned int end) {
+            for (unsigned int i = begin; i < end; i++)
+            {
+                AI& ai = ai_registry.components[i];
+                Entity entity = ai_registry.entities[i];
+                Motion& motion = registry.motions.get(entity);
+
+                // Check AI state and perform actions accordingly
+                switch (ai.state) {
+                case AI::AIState::IDLE:
+                    idleState(entity, ai, motion, elapsed_ms); // Now passing elapsed_ms
+                    break;
+                case AI::AIState::ACTIVE:
+                    activeState(entity, ai, motion, elapsed_ms);
+                    break;
+                default:
+                    printf("Unknown state\n");
+                    break;
+                }
+            }
+        });
+    }
+    spawnShots();
+}
 
-    while (!openSet.empty()) {
-        AStarNode* currentNode = openSet.top();
-        openSet.pop();
+void AISystem::requestShot(const AI& ai, Entity entity, const vec2& position, float angle)
+{
+    unsigned int order = (unsigned int)(&ai - registry.ais.components.data());
+    shot_queues[JobSystem::thread_index()].push_back({ order, ai.type, entity, position, angle });
+}
 
-        if (length(currentNode->position - goal) < 10.0f) { // Threshold to consider as goal reached
-            while (currentNode != nullptr) {
-                path.push_back(currentNode->position);
-                currentNode = currentNode->parent;
+// Creates the projectiles of the step, creating entities is not safe during the parallel part
+void AISystem::spawnShots()
+{
+    shots.clear();
+    for (std::vector<ShotRequest>& queue : shot_queues) {
+        shots.insert(shots.end(), queue.begin(), queue.end());
+        queue.clear();
+    }
+    // the jobs finish in any order, the entities are created in the same order every run
+    std::sort(shots.begin(), shots.end(), [](const ShotRequest& a, const ShotRequest& b) { return a.order < b.order; });
+
+    for (const ShotRequest& shot : shots) {
+        switch (shot.type) {
+        case AI::AIType::RANGED:
+            createEnemySniperProjectile(renderer, shot.position, shot.angle, shot.source);
+            break;
+        case AI::AIType::SHOTGUN:
+            for (int i = 0; i < 10; i++) {
+                createShotgunProjectile(renderer, shot.position, shot.angle, 0.0, 0.0, i, shot.source);
             }
-            std::reverse(path.begin(), path.end());
+            break;
+        case AI::AIType::ROCKET:
+            for (int i = 0; i < 5; i++) {
+                createEnemyRocketProjectile(renderer, shot.position, shot.angle, shot.source);
+            }
+            break;
+        case AI::AIType::FLAMETHROWER:
+            createEnemyFlamethrowerProjectile(renderer, shot.position, shot.angle, shot.source);
+            break;
+        case AI::AIType::TURRET:
+            createEnemyProjectile(renderer, shot.position, shot.angle, shot.source);
+            break;
+        default:
             break;
         }
+    }
+}
 
-        std::vector<vec2> neighbors = generateNeighbors(currentNode->position);
-
-        for (auto& neighborPos : neighbors) {
-            if (isObstacleAtPosition(neighborPos)) continue;
-
-            float tentative_gScore = currentNode->gCost + length(neighborPos - currentNode->position);
-            AStarNode* neighborNode = allNodes.find(neighborPos) != allNodes.end() ? allNodes[neighborPos] : nullptr;
+// Think cycles refresh the expensive decisions of the AIs (the way to the player or to a cell to shoot from),
+// the steering and shooting in activeState run every step on their results.
+// An AI is due every 'frequency' steps. The due AIs think in round robin order, at most as many per step
+// as spreads all AIs evenly over their cycles.
+void AISystem::think()
+{
+    PROFILE_SCOPE("ai.think");
+    auto& ai_registry = registry.ais;
+    unsigned int count = ai_registry.size();
+    if (count == 0 || registry.players.size() == 0) {
+        return;
+    }
+    vec2 playerPosition = registry.motions.get(registry.players.entities[0]).position;
 
-            if (neighborNode == nullptr || tentative_gScore < neighborNode->gCost) {
-                if (neighborNode == nullptr) {
-                    neighborNode = new AStarNode{ neighborPos, tentative_gScore, heuristic(neighborPos, goal), currentNode };
-                    allNodes[neighborPos] = neighborNode;
-                    openSet.push(neighborNode);
-                }
-                else {
-                    neighborNode->gCost = tentative_gScore;
-                    neighborNode->parent = currentNode;
-                }
-            }
+    float cyclesPerStep = 0.f;
+    for (AI& ai : ai_registry.components) {
+        if (ai.counter > 0) {
+            ai.counter--;
         }
+        cyclesPerStep += 1.f / std::max(ai.frequency, 1);
     }
+    int maxThinks = (int)ceil(cyclesPerStep);
 
-    for (auto& nodePair : allNodes) {
-        delete nodePair.second;
+    int thinks = 0;
+    unsigned int first = think_cursor % count;
+    for (unsigned int k = 0; k < count && thinks < maxThinks; k++) {
+        unsigned int i = (first + k) % count;
+        AI& ai = ai_registry.components[i];
+        if (ai.counter > 0) {
+            continue;
+        }
+        thinkCycle(ai_registry.entities[i], ai, playerPosition);
+        think_cursor = i + 1;
+        thinks++;
     }
-    allNodes.clear();
+}
 
-    return path;
+void AISystem::thinkCycle(Entity entity, AI& ai, const vec2& playerPosition)
+{
+    const vec2& position = registry.motions.get(entity).position;
+    bool shooter = ai.type != AI::AIType::MELEE && ai.type != AI::AIType::TURRET;
+    ai.waypoint = shooter && !ai.sees_player ? firingCellWaypoint(position, playerPosition) : flowFieldWaypoint(position, playerPosition);
+    ai.counter = ai.frequency;
+    // idle AIs wake up at their think cycle
+    ai.state = AI::AIState::ACTIVE;
 }
 
-// Utility function to limit the magnitude of a vector to max
-vec2 AISystem::limit(vec2 v, float max) {
-    if (length(v) > max) {
-        return normalize(v) * max;
+// Whether every AI sees the player, a bit test each on the cells collected for the player's cell.
+// It is cheap enough to refresh every step instead of only at the think cycles.
+void AISystem::updateSight(const vec2& playerPosition)
+{
+    PROFILE_SCOPE("ai.sight");
+    player_visibility.update(currentRoom(), toGridCoord(playerPosition));
+
+    auto& ai_registry = registry.ais;
+    for (uint i = 0; i < ai_registry.size(); i++) {
+        const vec2& position = registry.motions.get(ai_registry.entities[i]).position;
+        ivec2 cell = toGridCoord(position);
+        // AIs outside the grid (in a doorway) walk their line
+        ai_registry.components[i].sees_player = in_room_grid(cell) ? player_visibility.visible_from(cell) : lineOfSightClear(position, playerPosition);
     }
-    return v;
 }
 
-void AISystem::step(float elapsed_ms)
+void AISystem::buildNeighborGrids()
 {
-    auto& ai_registry = registry.ais;
-    for (uint i = 0; i < ai_registry.size(); i++)
-    {
-        AI& ai = ai_registry.components[i];
-        Entity entity = ai_registry.entities[i];
+    neighbor_points.clear();
+    for (Entity entity : registry.ais.entities) {
         Motion& motion = registry.motions.get(entity);
+        neighbor_points.push_back({ motion.position, motion.velocity });
+    }
+    ai_neighbors.build(neighbor_points);
 
-        // Check AI state and perform actions accordingly
-        switch (ai.state) {
-        case AI::AIState::IDLE:
-            idleState(entity, ai, motion, elapsed_ms); // Now passing elapsed_ms
-            break;
-        case AI::AIState::ACTIVE:
-            activeState(entity, ai, motion, elapsed_ms);
-            break;
-        default:
-            printf("Unknown state\n");
-            break;
-        }
+    // AIs are steered by the AI grid only, even if they are obstacles or projectiles as well
+    neighbor_points.clear();
+    for (Entity entity : registry.obstacles.entities) {
+        if (registry.ais.has(entity)) continue;
+        neighbor_points.push_back({ registry.motions.get(entity).position, vec2(0.f) });
+    }
+    obstacle_neighbors.build(neighbor_points);
 
-        // Always update position based on velocity, regardless of state << shouldn't physics system do this?
-        // motion.position += motion.velocity * elapsed_ms / 1000.0f;
+    neighbor_points.clear();
+    for (Entity entity : registry.projectiles.entities) {
+        if (registry.ais.has(entity)) continue;
+        neighbor_points.push_back({ registry.motions.get(entity).position, vec2(0.f) });
     }
+    projectile_neighbors.build(neighbor_points);
 }
 
 void AISystem::idleState(Entity entity, AI& ai, Motion& motion, float elapsed_ms) {
-    // Example condition to switch to active state based on a simple timer
-    ai.counter += elapsed_ms;
-    if (ai.counter >= ai.frequency) {
-        ai.counter = 0;
-        ai.state = AI::AIState::ACTIVE;
-    }
+    // Stays idle until its next think cycle (see thinkCycle)
 
     // Optionally, apply some basic motion or behavior even in idle state
     // For example, slowing down or stopping:
@@ -294,173 +340,110 @@ void rotateTowardsPlayer(Motion& motion, const vec2& playerPosition, float viewT
 
 // https://vanhunteradams.com/Pico/Animal_Movement/Boids-algorithm.html
 // Algorithm adapted from the above link
-void AISystem::handleBoidMovement(Entity entity, Motion& motion, float elapsed_ms, const vec2& playerPosition, float separationForce, float separationWeight, float friendlyAvoidanceDistance, float obstacleAvoidanceDistance, float projectileAvoidanceDistance, float playerAvoidanceDistance, float alignmentForce, float alignmentDistance, float alignmentWeight, float cohesionForce, float cohesionWeight, float cohesionDistance, float playerFollowDistance, float maxSpeed, float forceWeight) {
-    // SEPERATION
-    vec2 separation(0.0f, 0.0f); // Separation accumulator
-    // Calculate separation force based on all motion entities
-    float close_dx = 0.0f, close_dy = 0.0f;
-    // avoid other ais
-    for (auto& otherEntity : registry.ais.entities) { // Could be optimized to consider only nearby entities or a subset
-        if (otherEntity == entity) continue; // Skip self
-
-        Motion& otherMotion = registry.motions.get(otherEntity);
-        float distance = length(motion.position - otherMotion.position);
-        // avoid other entities if too close
-        if (distance < friendlyAvoidanceDistance) {
-            close_dx += motion.position.x - otherMotion.position.x;
-            close_dy += motion.position.y - otherMotion.position.y;
+// All moving AIs are steered in one batch: their state is gathered into arrays, the neighbor sums come from
+// the SIMD kernel of the grids (NeighborGrid::sums_within), and the new velocities are written back at the end.
+void AISystem::steerBoids(const vec2& playerPosition) {
+    PROFILE_SCOPE("ai.steer");
 
+    // GATHER
+    boids.clear();
+    auto& ai_registry = registry.ais;
+    for (uint i = 0; i < ai_registry.size(); i++) {
+        const AI& ai = ai_registry.components[i];
+        const AIParams& params = params_of(ai.type);
+        if (ai.state != AI::AIState::ACTIVE || params.maxSpeed <= 0.f) {
+            continue;
         }
+        Entity entity = ai_registry.entities[i];
+        const Motion& motion = registry.motions.get(entity);
+        boids.add(entity, params, motion.position, motion.velocity, ai.sees_player ? playerPosition : ai.waypoint);
     }
-    // avoid obstacles
-    for (auto& otherEntity : registry.obstacles.entities) { // Could be optimized to consider only nearby entities or a subset
-        if (otherEntity == entity || registry.ais.has(otherEntity)) continue; // Skip self
-
-        Motion& otherMotion = registry.motions.get(otherEntity);
-        float distance = length(motion.position - otherMotion.position);
-        // avoid other entities if too close
-        if (distance < obstacleAvoidanceDistance) {
-            close_dx += motion.position.x - otherMotion.position.x;
-            close_dy += motion.position.y - otherMotion.position.y;
-        }
-    }
-    // avoid projectiles
-    for (auto& otherEntity : registry.projectiles.entities) { // Could be optimized to consider only nearby entities or a subset
-        if (otherEntity == entity || registry.ais.has(otherEntity)) continue; // Skip self
 
-        Motion& otherMotion = registry.motions.get(otherEntity);
-        float distance = length(motion.position - otherMotion.position);
-        // avoid other entities if too close
-        if (distance < projectileAvoidanceDistance) {
-            close_dx += motion.position.x - otherMotion.position.x;
-            close_dy += motion.position.y - otherMotion.position.y;
-        }
-    }
-    // avoid player
-    float distanceToPlayer = length(motion.position - playerPosition);
-    if (distanceToPlayer < playerAvoidanceDistance) {
-        close_dx += motion.position.x - playerPosition.x;
-        close_dy += motion.position.y - playerPosition.y;
-    }
-    separation.x += close_dx * separationForce;
-    separation.y -= close_dy * separationForce;
+    // Turn towards the center of the world if near the edge
+    const float topMargin = yMin + 2 * cellSize + halfCellSize;
+    const float bottomMargin = yMax - 2 * cellSize - halfCellSize;
+    const float leftMargin = xMin + 2 * cellSize + halfCellSize;
+    const float rightMargin = xMax - 2 * cellSize - halfCellSize;
+    const float turn_factor = 100.f;
+
+    // the sums read the grids built at the start of the step and every AI writes only its own slot of the batch
+    jobs.parallel_for(boids.size(), aiBatchSize, [&](unsigned int begin, unsigned int end) {
+        for (unsigned int i = begin; i < end; i++) {
+            const AIParams& params = *boids.params[i];
+            const vec2 position = vec2(boids.x[i], boids.y[i]);
+            const vec2 velocity = vec2(boids.vx[i], boids.vy[i]);
+
+            // SEPERATION
+            // avoid other ais, obstacles and projectiles that are too close, the AI itself adds nothing
+            vec2 close = ai_neighbors.sums_within(position, params.friendlyAvoidanceDistance).offset
+                + obstacle_neighbors.sums_within(position, params.obstacleAvoidanceDistance).offset
+                + projectile_neighbors.sums_within(position, params.projectileAvoidanceDistance).offset;
+            // avoid player
+            float distanceToPlayer = length(position - playerPosition);
+            if (distanceToPlayer < params.playerAvoidanceDistance) {
+                close += position - playerPosition;
+            }
+            vec2 separation = vec2(close.x, -close.y) * params.separationForce;
+
+            // ALLIGNMENT
+            // match the group's average velocity, the sums include the AI itself
+            vec2 alignment(0.0f, 0.0f);
+            NeighborGrid::Sums flock = ai_neighbors.sums_within(position, params.alignmentDistance);
+            int neighborCount = flock.count;
+            vec2 velocitySum = flock.velocity;
+            if (params.alignmentDistance > 0.f) {
+                neighborCount--;
+                velocitySum -= velocity;
+            }
+            if (neighborCount > 0) {
+                alignment = (velocitySum / (float)neighborCount - velocity) * params.alignmentForce;
+            }
 
+            // COHESION
+            // stay close to player, going around the obstacles that are in the way
+            vec2 cohesion(0.0f, 0.0f);
+            if (distanceToPlayer > params.playerFollowDistance) {
+                cohesion = (boids.follow[i] - position) * params.cohesionForce;
+            }
 
-    // ALLIGNMENT
-    vec2 alignment(0.0f, 0.0f); // Alignment accumulator
-    // Calculate group's average velocity for alignment force
-    float x_vel_avg = 0.0f, y_vel_avg = 0.0f;
-    int neighborCount = 0;
-    for (auto& otherAI : registry.ais.entities) {
-        if (otherAI == entity) continue; // Skip self
+            // Combine all behaviors with weighted factors
+            vec2 steer = (alignment * params.alignmentWeight) + (cohesion * params.cohesionWeight) + (separation * params.separationWeight);
 
-        Motion& otherMotion = registry.motions.get(otherAI);
-        float distance = length(motion.position - otherMotion.position);
+            if (position.x <= leftMargin) {
+                steer.x += turn_factor;
+            }
+            else if (rightMargin <= position.x) {
+                steer.x -= turn_factor;
+            }
+            if (position.y <= topMargin) {
+                steer.y += turn_factor;
+            }
+            else if (bottomMargin <= position.y) {
+                steer.y -= turn_factor;
+            }
 
-        if (distance < alignmentDistance) {
-            x_vel_avg += otherMotion.velocity.x;
-            y_vel_avg += otherMotion.velocity.y;
-            neighborCount++;
+            vec2 newVelocity = velocity + steer * params.forceWeight;
+            if (length(newVelocity) > params.maxSpeed) {
+                newVelocity = normalize(newVelocity) * params.maxSpeed;
+            }
+            boids.vx[i] = newVelocity.x;
+            boids.vy[i] = newVelocity.y;
         }
-    }
-    if (neighborCount > 0) {
-        x_vel_avg /= neighborCount;
-        y_vel_avg /= neighborCount;
-        alignment.y += (y_vel_avg - motion.velocity.y) * alignmentForce;
-        alignment.x += (x_vel_avg - motion.velocity.x) * alignmentForce;
-    }
-
-
-    // COHESION
-    vec2 cohesion(0.0f, 0.0f); // Cohesion accumulator
-    // Calculate group's center of mass for cohesion force
-    float x_pos_avg = 0.0f, y_pos_avg = 0.0f;
-    neighborCount = 0;
-    //for (auto& otherAI : registry.ais.entities) {
-    //    if (otherAI == entity) continue; // Skip self
-
-    //    Motion& otherMotion = registry.motions.get(otherAI);
-    //    float distance = length(motion.position - otherMotion.position);
+    });
 
-    //    if (distance < cohesionDistance) {
-    //        x_pos_avg += otherMotion.position.x;
-    //        y_pos_avg += otherMotion.position.y;
-    //        neighborCount++;
-    //    }
-    //}
-    // stay close to player
-    if (distanceToPlayer > playerFollowDistance) {
-        x_pos_avg += playerPosition.x;
-        y_pos_avg += playerPosition.y;
-        neighborCount++;
-    }
-    if (neighborCount > 0) {
-        x_pos_avg /= neighborCount;
-        y_pos_avg /= neighborCount;
-        cohesion.x += (x_pos_avg - motion.position.x) * cohesionForce;
-        cohesion.y += (y_pos_avg - motion.position.y) * cohesionForce;
-    }
-
-    // Combine all behaviors with weighted factors
-    vec2 steer = (alignment * alignmentWeight) + (cohesion * cohesionWeight) + (separation * separationWeight);
-
-    // Turn towards the center of the world if near the edge
-    float topMargin = yMin + 2 * cellSize + halfCellSize;
-    float bottomMargin = yMax - 2 * cellSize - halfCellSize;
-    float leftMargin = xMin + 2 * cellSize + halfCellSize;
-    float rightMargin = xMax - 2 * cellSize - halfCellSize;
-
-    float turn_factor = 100.f;
-    if (motion.position.x <= leftMargin) {
-        steer.x += turn_factor;
-    }
-    else if (rightMargin <= motion.position.x) {
-        steer.x -= turn_factor;
-    }
-    if (motion.position.y <= topMargin) {
-        steer.y += turn_factor;
+    // SCATTER
+    for (uint i = 0; i < boids.size(); i++) {
+        registry.motions.get(boids.entities[i]).velocity = vec2(boids.vx[i], boids.vy[i]);
     }
-    else if (bottomMargin <= motion.position.y) {
-        steer.y -= turn_factor;
-    }
-
-    motion.velocity += steer * forceWeight;
-    motion.velocity = limit(motion.velocity, maxSpeed);
 }
 
 void AISystem::handleMeleeAI(Entity entity, Motion& motion, AI& ai, float elapsed_ms, const vec2& playerPosition) {
-    float speed = 100.0f; // Tune this value as needed
-    float maxTurnSpeed = 3.f; // Maximum turn speed
-    float turnSpeed = 0.1f; // Turn acceleration
-    float viewThreshold = .5f; // Threshold for angle difference
-
-    float separationForce = 1.0f; // base separation force
-    float separationWeight = .5f; // separation weight when combined with other forces
-    float friendlyAvoidanceDistance = 150.0f; // Distance to avoid other entities
-    float obstacleAvoidanceDistance = 50.0f; // Distance to avoid obstacles
-    float projectileAvoidanceDistance = 150.0f; // Distance to avoid projectiles
-    float playerAvoidanceDistance = 0.0f; // Distance to avoid player
-
-    float alignmentForce = 1.f; // base alignment force
-    float alignmentWeight = .5; // alignment weight when combined with other forces
-    float alignmentDistance = 200.0f; // Distance to consider for alignment
-
-    float cohesionForce = 10.f; // base cohesion force
-    float cohesionWeight = 10.5f; // cohesion weight when combined with other forces
-    float cohesionDistance = 0.0f; // Distance to consider for cohesion
-    float playerFollowDistance = 0.0f; // Distance to follow the player
-
-    float maxSpeed = 200.0f; // Adjust as needed
-    float forceWeight = 1.f; // Overall weight for steering force
-
-    float distanceToPlayer = length(playerPosition - motion.position);
-
-    handleBoidMovement(entity, motion, elapsed_ms, playerPosition, separationForce, separationWeight, friendlyAvoidanceDistance, obstacleAvoidanceDistance, projectileAvoidanceDistance, playerAvoidanceDistance, alignmentForce, alignmentDistance, alignmentWeight, cohesionForce, cohesionWeight, cohesionDistance, playerFollowDistance, maxSpeed, forceWeight);
+    const AIParams& params = params_of(AI::AIType::MELEE);
 
     // Check for line of sight
-    if (lineOfSightClear(motion.position, playerPosition)) {
+    if (ai.sees_player) {
         // Rotate towards player if in line of sight
-        rotateTowardsPlayer(motion, playerPosition, viewThreshold, turnSpeed, maxTurnSpeed, M_PI / 2);
+        rotateTowardsPlayer(motion, playerPosition, params.viewThreshold, params.turnSpeed, params.maxTurnSpeed, params.lookOffset);
     }
     else {
         motion.turn_speed = 0.0f;
@@ -468,46 +451,20 @@ void AISystem::handleMeleeAI(Entity entity, Motion& motion, AI& ai, float elapse
 }
 
 void AISystem::handleRangedAI(Entity entity, Motion& motion, AI& ai, float elapsed_ms, const vec2& playerPosition) {
-    float maxTurnSpeed = 3.f; // Maximum turn speed
-    float turnSpeed = 0.1f; // Turn acceleration
-    float viewThreshold = .5f; // Threshold for angle difference that determines when it is facing the player
-
-    float shootingRange = 500.0f; // Distance to shoot at the player
-
-    float separationForce = 1.0f; // base separation force
-    float separationWeight = 1.0f; // separation weight when combined with other forces
-    float friendlyAvoidanceDistance = 150.0f; // Distance to avoid other entities
-    float obstacleAvoidanceDistance = 50.0f; // Distance to avoid obstacles
-    float projectileAvoidanceDistance = 150.0f; // Distance to avoid projectiles
-    float playerAvoidanceDistance = 200.0f; // Distance to avoid player
-
-    float alignmentForce = 1.f; // base alignment force
-    float alignmentWeight = .5f; // alignment weight when combined with other forces
-    float alignmentDistance = 200.0f; // Distance to consider for alignment
-
-    float cohesionForce = 1.f; // base cohesion force
-    float cohesionWeight = .5f; // cohesion weight when combined with other forces
-    float cohesionDistance = 200.0f; // Distance to consider for cohesion
-    float playerFollowDistance = 300.0f; // Distance to follow the player
-
-    float maxSpeed = 200.0f; // Adjust as needed
-    float forceWeight = 0.01f; // Overall weight for steering force
+    const AIParams& params = params_of(AI::AIType::RANGED);
 
     float distanceToPlayer = length(playerPosition - motion.position);
 
-    handleBoidMovement(entity, motion, elapsed_ms, playerPosition, separationForce, separationWeight, friendlyAvoidanceDistance, obstacleAvoidanceDistance, projectileAvoidanceDistance, playerAvoidanceDistance, alignmentForce, alignmentDistance, alignmentWeight, cohesionForce, cohesionWeight, cohesionDistance, playerFollowDistance, maxSpeed, forceWeight);
-
     // Shooting logic
     ai.shootingCooldown -= elapsed_ms / 1000.f; // Convert milliseconds to seconds
-    if (lineOfSightClear(motion.position, playerPosition)) {
-        vec2 direction = normalize(playerPosition - motion.position);
-        rotateTowardsPlayer(motion, playerPosition, viewThreshold, turnSpeed, maxTurnSpeed, -M_PI / 2);
+    if (ai.sees_player) {
+        rotateTowardsPlayer(motion, playerPosition, params.viewThreshold, params.turnSpeed, params.maxTurnSpeed, params.lookOffset);
 
-        if (distanceToPlayer <= shootingRange && ai.shootingCooldown <= 0) {
+        if (distanceToPlayer <= params.shootingRange && ai.shootingCooldown <= 0) {
             vec2 shootingDirection = normalize(playerPosition - motion.position);
             float shootingAngle = atan2(shootingDirection.y, shootingDirection.x);
-            createEnemySniperProjectile(renderer, motion.position, shootingAngle, entity);
-            ai.shootingCooldown = 1.f; // Reset cooldown
+            requestShot(ai, entity, motion.position, shootingAngle);
+            ai.shootingCooldown = params.shotInterval; // Reset cooldown
         }
     }
     else {
@@ -516,155 +473,64 @@ void AISystem::handleRangedAI(Entity entity, Motion& motion, AI& ai, float elaps
 }
 
 void AISystem::handleShotgunAI(Entity entity, Motion& motion, AI& ai, float elapsed_ms, const vec2& playerPosition) {
-    float maxTurnSpeed = 3.f; // Maximum turn speed
-    float turnSpeed = 0.1f; // Turn acceleration
-    float viewThreshold = .5f; // Threshold for angle difference that determines when it is facing the player
-
-    float shootingRange = 250.0f; // Distance to shoot at the player
-
-    float separationForce = 1.0f; // base separation force
-    float separationWeight = 1.0f; // separation weight when combined with other forces
-    float friendlyAvoidanceDistance = 150.0f; // Distance to avoid other entities
-    float obstacleAvoidanceDistance = 50.0f; // Distance to avoid obstacles
-    float projectileAvoidanceDistance = 150.0f; // Distance to avoid projectiles
-    float playerAvoidanceDistance = 50.0f; // Distance to avoid player
-
-    float alignmentForce = 1.f; // base alignment force
-    float alignmentWeight = .5f; // alignment weight when combined with other forces
-    float alignmentDistance = 200.0f; // Distance to consider for alignment
-
-    float cohesionForce = 1.f; // base cohesion force
-    float cohesionWeight = .5f; // cohesion weight when combined with other forces
-    float cohesionDistance = 200.0f; // Distance to consider for cohesion
-    float playerFollowDistance = 100.f; // Distance to follow the player
-
-    float maxSpeed = 250.0f; // Adjust as needed
-    float forceWeight = 0.01f; // Overall weight for steering force
+    const AIParams& params = params_of(AI::AIType::SHOTGUN);
 
     float distanceToPlayer = length(playerPosition - motion.position);
 
-    // Movement logic considering player's distance and projectiles
-    handleBoidMovement(entity, motion, elapsed_ms, playerPosition, separationForce, separationWeight, friendlyAvoidanceDistance, obstacleAvoidanceDistance, projectileAvoidanceDistance, playerAvoidanceDistance, alignmentForce, alignmentDistance, alignmentWeight, cohesionForce, cohesionWeight, cohesionDistance, playerFollowDistance, maxSpeed, forceWeight);
-
     // Shooting logic
     ai.shootingCooldown -= elapsed_ms / 1000.f; // Convert milliseconds to seconds
-    if (lineOfSightClear(motion.position, playerPosition)) {
-        vec2 direction = normalize(playerPosition - motion.position);
-        //motion.look_angle = atan2(direction.y, direction.x) - M_PI/2;
-        rotateTowardsPlayer(motion, playerPosition, viewThreshold, turnSpeed, maxTurnSpeed, - M_PI / 2);
+    if (ai.sees_player) {
+        rotateTowardsPlayer(motion, playerPosition, params.viewThreshold, params.turnSpeed, params.maxTurnSpeed, params.lookOffset);
 
-        if (distanceToPlayer <= shootingRange && ai.shootingCooldown <= 0) {
+        if (distanceToPlayer <= params.shootingRange && ai.shootingCooldown <= 0) {
             vec2 shootingDirection = normalize(playerPosition - motion.position);
             float shootingAngle = atan2(shootingDirection.y, shootingDirection.x);
-            for (int i = 0; i < 10; i++) {
-                createShotgunProjectile(renderer, motion.position, shootingAngle, 0.0, 0.0, i, entity);
-            }
-            ai.shootingCooldown = 1.5f; // Reset cooldown
+            requestShot(ai, entity, motion.position, shootingAngle);
+            ai.shootingCooldown = params.shotInterval; // Reset cooldown
         }
     }
     else {
-		motion.turn_speed = 0.0f;
-	}
+        motion.turn_speed = 0.0f;
+    }
 }
 
 void AISystem::handleRocketAI(Entity entity, Motion& motion, AI& ai, float elapsed_ms, const vec2& playerPosition) {
-    float maxTurnSpeed = 3.f; // Maximum turn speed
-    float turnSpeed = 0.1f; // Turn acceleration
-    float viewThreshold = .5f; // Threshold for angle difference that determines when it is facing the player
-
-    float shootingRange = 500.0f; // Distance to shoot at the player
-
-    float separationForce = 1.0f; // base separation force
-    float separationWeight = 1.5f; // separation weight when combined with other forces
-    float friendlyAvoidanceDistance = 150.0f; // Distance to avoid other entities
-    float obstacleAvoidanceDistance = 100.0f; // Distance to avoid obstacles
-    float projectileAvoidanceDistance = 250.0f; // Distance to avoid projectiles
-    float playerAvoidanceDistance = 50.0f; // Distance to avoid player
-
-    float alignmentForce = 1.f; // base alignment force
-    float alignmentDistance = 200.0f; // Distance to consider for alignment
-    float alignmentWeight = .5f; // alignment weight when combined with other forces
-
-    float cohesionForce = 1.f; // base cohesion force
-    float cohesionWeight = .5f; // cohesion weight when combined with other forces
-    float cohesionDistance = 200.0f; // Distance to consider for cohesion
-    float playerFollowDistance = 300.0f; // Distance to follow the player
-
-    float maxSpeed = 50.0f; // Adjust as needed
-    float forceWeight = 0.01f; // Overall weight for steering force
+    const AIParams& params = params_of(AI::AIType::ROCKET);
 
     float distanceToPlayer = length(playerPosition - motion.position);
 
-    // Movement logic considering player's distance and projectiles
-    handleBoidMovement(entity, motion, elapsed_ms, playerPosition, separationForce, separationWeight, friendlyAvoidanceDistance, obstacleAvoidanceDistance, projectileAvoidanceDistance, playerAvoidanceDistance, alignmentForce, alignmentDistance, alignmentWeight, cohesionForce, cohesionWeight, cohesionDistance, playerFollowDistance, maxSpeed, forceWeight);
-    
     // Shooting logic
     ai.shootingCooldown -= elapsed_ms / 1000.f; // Convert milliseconds to seconds
-    if (lineOfSightClear(motion.position, playerPosition)) {
-        vec2 direction = normalize(playerPosition - motion.position);
-        //motion.look_angle = atan2(direction.y, direction.x) + M_PI / 2;
-        rotateTowardsPlayer(motion, playerPosition, viewThreshold, turnSpeed, maxTurnSpeed, M_PI / 2);
+    if (ai.sees_player) {
+        rotateTowardsPlayer(motion, playerPosition, params.viewThreshold, params.turnSpeed, params.maxTurnSpeed, params.lookOffset);
 
-        if (distanceToPlayer <= shootingRange && ai.shootingCooldown <= 0) {
+        if (distanceToPlayer <= params.shootingRange && ai.shootingCooldown <= 0) {
             vec2 shootingDirection = normalize(playerPosition - motion.position);
             float shootingAngle = atan2(shootingDirection.y, shootingDirection.x);
-            for (int i = 0; i < 5; i++) {
-                createEnemyRocketProjectile(renderer, motion.position, shootingAngle, entity);
-            }
-            ai.shootingCooldown = 1.5f; // Reset cooldown
+            requestShot(ai, entity, motion.position, shootingAngle);
+            ai.shootingCooldown = params.shotInterval; // Reset cooldown
         }
     }
     else {
         motion.turn_speed = 0.0f;
-	
     }
 }
 
 void AISystem::handleFlameAI(Entity entity, Motion& motion, AI& ai, float elapsed_ms, const vec2& playerPosition) {
-    float maxTurnSpeed = 3.f; // Maximum turn speed
-    float turnSpeed = 0.1f; // Turn acceleration
-    float viewThreshold = .5f; // Threshold for angle difference that determines when it is facing the player
-
-    float shootingRange = 250.0f; // Distance to shoot at the player
-
-    float separationForce = 1.0f; // base separation force
-    float separationWeight = 1.0f; // separation weight when combined with other forces
-    float friendlyAvoidanceDistance = 150.0f; // Distance to avoid other entities
-    float obstacleAvoidanceDistance = 100.0f; // Distance to avoid obstacles
-    float projectileAvoidanceDistance = 250.0f; // Distance to avoid projectiles
-    float playerAvoidanceDistance = 50.0f; // Distance to avoid player
-
-    float alignmentForce = 1.f; // base alignment force
-    float alignmentDistance = 50.0f; // Distance to consider for alignment
-    float alignmentWeight = .5f; // alignment weight when combined with other forces
-
-    float cohesionForce = 1.f; // base cohesion force
-    float cohesionWeight = .5f; // cohesion weight when combined with other forces
-    float cohesionDistance = 50.0f; // Distance to consider for cohesion
-    float playerFollowDistance = 300.0f; // Distance to follow the player
-
-    float maxSpeed = 150.0f; // Adjust as needed
-    float forceWeight = 0.01f; // Overall weight for steering force
+    const AIParams& params = params_of(AI::AIType::FLAMETHROWER);
 
     float distanceToPlayer = length(playerPosition - motion.position);
 
-    // Movement logic considering player's distance and projectiles
-    handleBoidMovement(entity, motion, elapsed_ms, playerPosition, separationForce, separationWeight, friendlyAvoidanceDistance, obstacleAvoidanceDistance, projectileAvoidanceDistance, playerAvoidanceDistance, alignmentForce, alignmentDistance, alignmentWeight, cohesionForce, cohesionWeight, cohesionDistance, playerFollowDistance, maxSpeed, forceWeight);
-
     // Shooting logic
     ai.shootingCooldown -= elapsed_ms / 1000.f; // Convert milliseconds to seconds
-    if (lineOfSightClear(motion.position, playerPosition)) {
-        vec2 direction = normalize(playerPosition - motion.position);
-        //motion.look_angle = atan2(direction.y, direction.x) - M_PI / 2;
-        // too short need to add pi/4
-        // pi/2 + pi/4 = 3pi/4
-        rotateTowardsPlayer(motion, playerPosition, viewThreshold, turnSpeed, maxTurnSpeed, -3 * M_PI / 4);
-
-        if (distanceToPlayer <= shootingRange && ai.shootingCooldown <= 0) {
+    if (ai.sees_player) {
+        rotateTowardsPlayer(motion, playerPosition, params.viewThreshold, params.turnSpeed, params.maxTurnSpeed, params.lookOffset);
+
+        if (distanceToPlayer <= params.shootingRange && ai.shootingCooldown <= 0) {
             vec2 shootingDirection = normalize(playerPosition - motion.position);
             float shootingAngle = atan2(shootingDirection.y, shootingDirection.x);
-            createEnemyFlamethrowerProjectile(renderer, motion.position, shootingAngle, entity);
-            ai.shootingCooldown = 0.05f; // Reset cooldown
+            requestShot(ai, entity, motion.position, shootingAngle);
+            ai.shootingCooldown = params.shotInterval; // Reset cooldown
         }
     }
     else {
@@ -673,21 +539,19 @@ void AISystem::handleFlameAI(Entity entity, Motion& motion, AI& ai, float elapse
 }
 
 void AISystem::handleTurretAI(Entity entity, Motion& motion, AI& ai, float elapsed_ms, const vec2& playerPosition) {
-    float maxTurnSpeed = 2.f; // Maximum turn speed
-    float turnSpeed = 2.f; // Turn acceleration
-    float viewThreshold = .5f; // Threshold for angle difference
+    const AIParams& params = params_of(AI::AIType::TURRET);
     // Check for line of sight to the player
-    if (lineOfSightClear(motion.position, playerPosition)) {
+    if (ai.sees_player) {
         // Rotate turret to face player - Calculate the angle between the turret and the player
-        rotateTowardsPlayer(motion, playerPosition, viewThreshold, turnSpeed, maxTurnSpeed, M_PI / 2);
+        rotateTowardsPlayer(motion, playerPosition, params.viewThreshold, params.turnSpeed, params.maxTurnSpeed, params.lookOffset);
 
         // Shooting logic, no range for these long ranged turrets
         ai.shootingCooldown -= elapsed_ms / 1000.f; // Cooldown reduction
         if (ai.shootingCooldown <= 0) {
             vec2 shootingDirection = normalize(playerPosition - motion.position);
             float shootingAngle = atan2(shootingDirection.y, shootingDirection.x);
-            createEnemyProjectile(renderer, motion.position, shootingAngle, entity);
-            ai.shootingCooldown = .5f; // Reset cooldown
+            requestShot(ai, entity, motion.position, shootingAngle);
+            ai.shootingCooldown = params.shotInterval; // Reset cooldown
         }
     }
     else {
@@ -5,19 +5,93 @@
 #include "render_system/render_system.hpp"
 #include "ecs_registry/ecs_registry.hpp"
 #include "common/common.hpp"
+#include "ai_system/neighbor_grid.hpp"
+#include "ai_system/grid_path.hpp"
+#include "ai_system/flow_field.hpp"
+#include "ai_system/visibility_field.hpp"
+#include "ai_system/ai_params.hpp"
 
 class AISystem
 {
 private:
 	RenderSystem* renderer;
-public:
-	AISystem(RenderSystem* _renderer) : renderer(_renderer) {};
-
-	bool AISystem::lineOfSightClear(const vec2& start, const vec2& end);
 
-	bool isObstacleAtPosition(const vec2& gridPosition);
+	// Positions of the AIs, obstacles and projectiles at the start of the step, for the boids steering
+	NeighborGrid ai_neighbors;
+	NeighborGrid obstacle_neighbors;
+	NeighborGrid projectile_neighbors;
+	std::vector<NeighborGrid::Point> neighbor_points;
+
+	GridPathfinder pathfinder;
+	// shortest ways to the player's cell, updated at the start of the step
+	FlowField player_flow;
+	// cells that see the player's cell, updated at the start of the step
+	VisibilityField player_visibility;
+	void updateSight(const vec2& playerPosition);
+
+	// moving AIs gathered for the batched boids steering, one array per field
+	struct BoidBatch
+	{
+		std::vector<Entity> entities;
+		std::vector<const AIParams*> params;
+		std::vector<float> x, y, vx, vy;
+		std::vector<vec2> follow; // where the cohesion pulls to
+
+		unsigned int size() const { return (unsigned int)entities.size(); }
+		void clear()
+		{
+			entities.clear();
+			params.clear();
+			x.clear();
+			y.clear();
+			vx.clear();
+			vy.clear();
+			follow.clear();
+		}
+		void add(Entity entity, const AIParams& p, vec2 position, vec2 velocity, vec2 follow_position)
+		{
+			entities.push_back(entity);
+			params.push_back(&p);
+			x.push_back(position.x);
+			y.push_back(position.y);
+			vx.push_back(velocity.x);
+			vy.push_back(velocity.y);
+			follow.push_back(follow_position);
+		}
+	};
+	BoidBatch boids;
+	void steerBoids(const vec2& playerPosition);
+
+	// A projectile fired during the parallel part of the step, created once it is over
+	struct ShotRequest
+	{
+		unsigned int order; // index of the AI, the shots are created in AI order like a serial step would
+		AI::AIType type;
+		Entity source;
+		vec2 position;
+		float angle;
+	};
+	// one queue per job system thread, so the jobs never share one
+	std::vector<std::vector<ShotRequest>> shot_queues;
+	std::vector<ShotRequest> shots;
+	void requestShot(const AI& ai, Entity entity, const vec2& position, float angle);
+	void spawnShots();
+
+	// the due AIs think in round robin order starting here
+	unsigned int think_cursor = 0;
+	void think();
+	void thinkCycle(Entity entity, AI& ai, const vec2& playerPosition);
+
+	void buildNeighborGrids();
+
+	const Room& currentRoom();
+
+	vec2 flowFieldWaypoint(const vec2& position, const vec2& playerPosition);
+	vec2 firingCellWaypoint(const vec2& position, const vec2& playerPosition);
+public:
+	AISystem(RenderSystem* _renderer) : renderer(_renderer) { load_ai_params(ai_params_path()); };
 
-	std::vector<vec2> generateNeighbors(const vec2& position);
+	bool lineOfSightClear(const vec2& start, const vec2& end);
 
 	std::vector<vec2> findPathAStar(const vec2& start, const vec2& goal);
 	
@@ -31,10 +105,6 @@ public:
 
 	void handleMeleeAI(Entity entity, Motion& motion, AI& ai, float elapsed_ms, const vec2& playerPosition);
 
-	vec2 limit(vec2 v, float max);
-
-	void handleBoidMovement(Entity entity, Motion& motion, float elapsed_ms, const vec2& playerPosition, float separationForce, float separationWeight, float friendlyAvoidanceDistance, float obstacleAvoidanceDistance, float projectileAvoidanceDistance, float playerAvoidanceDistance, float alignmentForce, float alignmentDistance, float alignmentWeight, float cohesionForce, float cohesionWeight, float cohesionDistance, float playerFollowDistance, float maxSpeed, float forceWeight);
-	
 	void handleTurretAI(Entity entity, Motion& motion, AI& ai, float elapsed_ms, const vec2& playerPosition);
 
 	void handleShotgunAI(Entity entity, Motion& motion, AI& ai, float elapsed_ms, const vec2& playerPosition);
@@ -42,6 +112,4 @@ public:
 	void handleRocketAI(Entity entity, Motion& motion, AI& ai, float elapsed_ms, const vec2& playerPosition);
 
 	void handleFlameAI(Entity entity, Motion& motion, AI& ai, float elapsed_ms, const vec2& playerPosition);
-
-	vec2 clampPositionToBounds(const vec2& position);
 };
\ No newline at end of file
@@ -0,0 +1,86 @@
+// internal
+#include "ai_system/flow_field.hpp"
+
+// stlib
+#include <algorithm>
+#include <functional>
+
+const float unreachable = 1e9f;
+const float diagonal_cost = 1.41421356f;
+
+FlowField::FlowField()
+{
+	std::fill(distances, distances + room_cell_count, unreachable);
+	for (int cell = 0; cell < room_cell_count; cell++)
+		next[cell] = cell;
+	open.reserve(8 * room_cell_count);
+}
+
+void FlowField::update(const Room& room, ivec2 target)
+{
+	if (target == this->target && room.occupancy_version == room_version)
+		return;
+	this->target = target;
+	room_version = room.occupancy_version;
+	solve(room);
+}
+
+void FlowField::solve(const Room& room)
+{
+	std::fill(distances, distances + room_cell_count, unreachable);
+	for (int cell = 0; cell < room_cell_count; cell++)
+		next[cell] = cell;
+	if (!in_room_grid(target))
+		return;
+
+	// Dijkstra outwards from the target, a cell points back to the cell it was reached from
+	std::greater<std::pair<float, int>> later;
+	int target_id = target.y * room_grid_size + target.x;
+	distances[target_id] = 0.f;
+	open.clear();
+	open.push_back({ 0.f, target_id });
+
+	const int offsets[8][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 } };
+	while (!open.empty()) {
+		std::pop_heap(open.begin(), open.end(), later);
+		std::pair<float, int> entry = open.back();
+		open.pop_back();
+		int current = entry.second;
+		if (entry.first > distances[current])
+			continue;
+
+		ivec2 cell = { current % room_grid_size, current / room_grid_size };
+		for (const auto& offset : offsets) {
+			ivec2 neighbor = { cell.x + offset[0], cell.y + offset[1] };
+			if (!in_room_grid(neighbor) || room.is_obstacle(neighbor))
+				continue;
+			bool diagonal = offset[0] != 0 && offset[1] != 0;
+			if (diagonal && (room.is_obstacle({ neighbor.x, cell.y }) || room.is_obstacle({ cell.x, neighbor.y })))
+				continue;
+
+			int id = neighbor.y * room_grid_size + neighbor.x;
+			float distance = entry.first + (diagonal ? diagonal_cost : 1.f);
+			if (distance >= distances[id])
+				continue;
+			distances[id] = distance;
+			next[id] = current;
+			open.push_back({ distance, id });
+			std::push_heap(open.begin(), open.end(), later);
+		}
+	}
+}
+
+ivec2 FlowField::next_cell(ivec2 cell) const
+{
+	if (!in_room_grid(cell))
+		return cell;
+	int id = next[cell.y * room_grid_size + cell.x];
+	return { id % room_grid_size, id / room_grid_size };
+}
+
+float FlowField::distance(ivec2 cell) const
+{
+	if (!in_room_grid(cell))
+		return unreachable;
+	return distances[cell.y * room_grid_size + cell.x];
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+
+#include "common/common.hpp"
+#include "components/components.hpp"
+
+// Distance field over the room grid toward one target cell (the player), shared by all enemies.
+// Every cell stores the next cell on a shortest path to the target, moving by the same rules as GridPathfinder,
+// so any number of chasers find their way around obstacles with one lookup each.
+// The field is only solved again when the target changes cell or the room obstacles change.
+class FlowField
+{
+public:
+	FlowField();
+
+	// Solves the field if the target cell or the room changed since the last update
+	void update(const Room& room, ivec2 target);
+
+	// Next cell toward the target, the cell itself at the target or when the target cannot be reached from it
+	ivec2 next_cell(ivec2 cell) const;
+
+	// Cost to walk from the cell to the target, in cells
+	float distance(ivec2 cell) const;
+
+private:
+	ivec2 target = { -1, -1 };
+	unsigned int room_version = 0;
+
+	float distances[room_cell_count];
+	int next[room_cell_count];
+	// (distance, cell) entries of the Dijkstra open list, kept to reuse its capacity
+	std::vector<std::pair<float, int>> open;
+
+	void solve(const Room& room);
+};
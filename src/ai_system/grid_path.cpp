@@ -0,0 +1,105 @@
+// internal
+#include "ai_system/grid_path.hpp"
+
+// stlib
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+const float diagonal_cost = 1.41421356f;
+
+// Octile distance, exact on an empty 8-connected grid
+static float heuristic(int from, int to)
+{
+	int dx = abs(from % room_grid_size - to % room_grid_size);
+	int dy = abs(from / room_grid_size - to / room_grid_size);
+	return (float)std::max(dx, dy) + (diagonal_cost - 1.f) * (float)std::min(dx, dy);
+}
+
+GridPathfinder::GridPathfinder()
+{
+	// every cell can be pushed once per neighbor at most
+	open.reserve(8 * room_cell_count);
+}
+
+const std::vector<ivec2>& GridPathfinder::find_path(const Room& room, ivec2 start, ivec2 goal)
+{
+	if (cache_version != room.occupancy_version) {
+		cache.clear();
+		cache_version = room.occupancy_version;
+	}
+
+	static const std::vector<ivec2> no_path;
+	if (!in_room_grid(start) || !in_room_grid(goal))
+		return no_path;
+
+	int start_id = start.y * room_grid_size + start.x;
+	int goal_id = goal.y * room_grid_size + goal.x;
+	auto cached = cache.find(start_id * room_cell_count + goal_id);
+	if (cached != cache.end())
+		return cached->second;
+
+	std::vector<ivec2>& path = cache[start_id * room_cell_count + goal_id];
+	search_path(room, start_id, goal_id, path);
+	return path;
+}
+
+void GridPathfinder::search_path(const Room& room, int start, int goal, std::vector<ivec2>& path)
+{
+	if (room.occupancy.test(goal))
+		return;
+
+	// a new search number invalidates all nodes of the previous search without clearing them
+	search++;
+	std::greater<std::pair<float, int>> later;
+
+	nodes[start].g = 0.f;
+	nodes[start].f = heuristic(start, goal);
+	nodes[start].parent = -1;
+	nodes[start].search = search;
+	nodes[start].closed = false;
+	open.clear();
+	open.push_back({ nodes[start].f, start });
+
+	const int offsets[8][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 } };
+	while (!open.empty()) {
+		std::pop_heap(open.begin(), open.end(), later);
+		int current = open.back().second;
+		open.pop_back();
+		// the entries of a cell from before a shorter way was found are skipped
+		if (nodes[current].closed)
+			continue;
+		nodes[current].closed = true;
+
+		if (current == goal) {
+			for (int cell = goal; cell != -1; cell = nodes[cell].parent)
+				path.push_back({ cell % room_grid_size, cell / room_grid_size });
+			std::reverse(path.begin(), path.end());
+			return;
+		}
+
+		ivec2 cell = { current % room_grid_size, current / room_grid_size };
+		for (const auto& offset : offsets) {
+			ivec2 next = { cell.x + offset[0], cell.y + offset[1] };
+			if (!in_room_grid(next) || room.is_obstacle(next))
+				continue;
+			bool diagonal = offset[0] != 0 && offset[1] != 0;
+			if (diagonal && (room.is_obstacle({ next.x, cell.y }) || room.is_obstacle({ cell.x, next.y })))
+				continue;
+
+			int id = next.y * room_grid_size + next.x;
+			float g = nodes[current].g + (diagonal ? diagonal_cost : 1.f);
+			Node& node = nodes[id];
+			if (node.search == search && (node.closed || g >= node.g))
+				continue;
+
+			node.g = g;
+			node.f = g + heuristic(id, goal);
+			node.parent = current;
+			node.search = search;
+			node.closed = false;
+			open.push_back({ node.f, id });
+			std::push_heap(open.begin(), open.end(), later);
+		}
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "common/common.hpp"
+#include "components/components.hpp"
+
+// A* over the cells of the room grid (see Room::occupancy), 8-connected, diagonal steps may not cut obstacle corners.
+// The nodes are integer cell ids in fixed arrays and the open list is a binary heap in a vector that keeps its capacity,
+// so a search does not allocate. Paths are cached per (start cell, goal cell) until the room obstacles change.
+class GridPathfinder
+{
+public:
+	GridPathfinder();
+
+	// Cells from start to goal, both included, empty if the goal cannot be reached or is outside the room
+	const std::vector<ivec2>& find_path(const Room& room, ivec2 start, ivec2 goal);
+
+private:
+	struct Node
+	{
+		float g = 0.f; // cost from the start
+		float f = 0.f; // g plus the heuristic to the goal
+		int parent = -1;
+		unsigned int search = 0; // the node is only valid for the search with this number
+		bool closed = false;
+	};
+
+	Node nodes[room_cell_count];
+	unsigned int search = 0;
+	// (f, cell) entries, a cell that gets a lower f is pushed again
+	std::vector<std::pair<float, int>> open;
+
+	// key is start cell * room_cell_count + goal cell
+	std::unordered_map<int, std::vector<ivec2>> cache;
+	unsigned int cache_version = 0;
+
+	void search_path(const Room& room, int start, int goal, std::vector<ivec2>& path);
+};
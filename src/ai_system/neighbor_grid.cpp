@@ -0,0 +1,106 @@
+// internal
+#include "ai_system/neighbor_grid.hpp"
+
+// NEIGHBOR_GRID_NO_SSE forces the scalar loop, e.g. to benchmark it against the SSE one
+#if !defined(NEIGHBOR_GRID_NO_SSE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define NEIGHBOR_GRID_SSE
+#include <emmintrin.h>
+#endif
+
+void NeighborGrid::build(const std::vector<Point>& points)
+{
+	// Counting sort of the points into the cells: count, prefix sum, fill
+	cell_start.assign(columns * rows + 1, 0);
+	for (const Point& point : points)
+		cell_start[cell_y(point.position.y) * columns + cell_x(point.position.x) + 1]++;
+	for (int cell = 0; cell < columns * rows; cell++)
+		cell_start[cell + 1] += cell_start[cell];
+
+	xs.resize(points.size());
+	ys.resize(points.size());
+	vxs.resize(points.size());
+	vys.resize(points.size());
+	cursor.assign(cell_start.begin(), cell_start.end() - 1);
+	for (const Point& point : points)
+	{
+		unsigned int i = cursor[cell_y(point.position.y) * columns + cell_x(point.position.x)]++;
+		xs[i] = point.position.x;
+		ys[i] = point.position.y;
+		vxs[i] = point.velocity.x;
+		vys[i] = point.velocity.y;
+	}
+}
+
+NeighborGrid::Sums NeighborGrid::sums_within(vec2 position, float radius) const
+{
+	Sums sums;
+	if (xs.empty())
+		return sums;
+	const float radius_squared = radius * radius;
+	const int y_end = cell_y(position.y + radius);
+	const int x_begin = cell_x(position.x - radius);
+	const int x_end = cell_x(position.x + radius);
+
+	float offset_x = 0.f, offset_y = 0.f, velocity_x = 0.f, velocity_y = 0.f, count = 0.f;
+#ifdef NEIGHBOR_GRID_SSE
+	const __m128 px = _mm_set1_ps(position.x);
+	const __m128 py = _mm_set1_ps(position.y);
+	const __m128 r2 = _mm_set1_ps(radius_squared);
+	const __m128 one = _mm_set1_ps(1.f);
+	__m128 sum_dx = _mm_setzero_ps(), sum_dy = _mm_setzero_ps();
+	__m128 sum_vx = _mm_setzero_ps(), sum_vy = _mm_setzero_ps(), sum_count = _mm_setzero_ps();
+#endif
+	for (int y = cell_y(position.y - radius); y <= y_end; y++)
+	{
+		unsigned int i = cell_start[y * columns + x_begin];
+		const unsigned int end = cell_start[y * columns + x_end + 1];
+#ifdef NEIGHBOR_GRID_SSE
+		// the points outside of the radius are masked out instead of branching
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 dx = _mm_sub_ps(px, _mm_loadu_ps(&xs[i]));
+			__m128 dy = _mm_sub_ps(py, _mm_loadu_ps(&ys[i]));
+			__m128 inside = _mm_cmplt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), r2);
+			sum_dx = _mm_add_ps(sum_dx, _mm_and_ps(inside, dx));
+			sum_dy = _mm_add_ps(sum_dy, _mm_and_ps(inside, dy));
+			sum_vx = _mm_add_ps(sum_vx, _mm_and_ps(inside, _mm_loadu_ps(&vxs[i])));
+			sum_vy = _mm_add_ps(sum_vy, _mm_and_ps(inside, _mm_loadu_ps(&vys[i])));
+			sum_count = _mm_add_ps(sum_count, _mm_and_ps(inside, one));
+		}
+#endif
+		for (; i < end; i++)
+		{
+			float dx = position.x - xs[i];
+			float dy = position.y - ys[i];
+			if (dx * dx + dy * dy < radius_squared)
+			{
+				offset_x += dx;
+				offset_y += dy;
+				velocity_x += vxs[i];
+				velocity_y += vys[i];
+				count += 1.f;
+			}
+		}
+	}
+
+#ifdef NEIGHBOR_GRID_SSE
+	float lanes[5][4];
+	_mm_storeu_ps(lanes[0], sum_dx);
+	_mm_storeu_ps(lanes[1], sum_dy);
+	_mm_storeu_ps(lanes[2], sum_vx);
+	_mm_storeu_ps(lanes[3], sum_vy);
+	_mm_storeu_ps(lanes[4], sum_count);
+	for (int lane = 0; lane < 4; lane++)
+	{
+		offset_x += lanes[0][lane];
+		offset_y += lanes[1][lane];
+		velocity_x += lanes[2][lane];
+		velocity_y += lanes[3][lane];
+		count += lanes[4][lane];
+	}
+#endif
+	sums.offset = { offset_x, offset_y };
+	sums.velocity = { velocity_x, velocity_y };
+	sums.count = (int)count;
+	return sums;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+
+#include "common/common.hpp"
+
+// Uniform grid over the window for the neighbor queries of the boids steering.
+// The points are copied into cell order, so a query only reads the few cells around it
+// instead of every AI, obstacle and projectile of the room.
+// The grid is rebuilt from scratch every AI step, its buffers are kept between steps so this does not allocate.
+class NeighborGrid
+{
+public:
+	struct Point
+	{
+		vec2 position;
+		vec2 velocity;
+	};
+
+	// two blocks, the typical avoidance distances (50 to 150) need 2x2 to 4x4 cells
+	static const int cell_size = 2 * game_window_block_size;
+	static const int columns = (window_width_px + cell_size - 1) / cell_size;
+	static const int rows = (window_height_px + cell_size - 1) / cell_size;
+
+	void build(const std::vector<Point>& points);
+
+	// What the boids steering needs from the points closer than radius to position
+	struct Sums
+	{
+		vec2 offset = { 0, 0 }; // sum of position - point
+		vec2 velocity = { 0, 0 };
+		int count = 0;
+	};
+
+	// Sums over the points closer than radius to position, 4 at a time with SSE where available
+	Sums sums_within(vec2 position, float radius) const;
+
+private:
+	// the points in cell c are at cell_start[c] .. cell_start[c + 1] of the arrays,
+	// which hold the points in cell order as structure of arrays for the SIMD sums
+	std::vector<unsigned int> cell_start;
+	std::vector<unsigned int> cursor;
+	std::vector<float> xs, ys, vxs, vys;
+
+	static int cell_x(float x) { return clamp((int)floor(x / cell_size), 0, columns - 1); }
+	static int cell_y(float y) { return clamp((int)floor(y / cell_size), 0, rows - 1); }
+};
@@ -0,0 +1,17 @@
+// internal
+#include "ai_system/visibility_field.hpp"
+
+void VisibilityField::update(const Room& room, ivec2 target)
+{
+	if (target == this->target && room.occupancy_version == room_version)
+		return;
+	this->target = target;
+	room_version = room.occupancy_version;
+
+	// a column of the room's visibility table, or the lines walked when the target is outside the grid (a doorway)
+	cells.reset();
+	for (int cell = 0; cell < room_cell_count; cell++) {
+		if (room.line_of_sight({ cell % room_grid_size, cell / room_grid_size }, target))
+			cells.set(cell);
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <bitset>
+
+#include "common/common.hpp"
+#include "components/components.hpp"
+
+// The room cells that have a line of sight to one target cell (the player), by the same lines as Room::line_of_sight.
+// It is collected in one pass over the grid whenever the target changes cell or the room obstacles change,
+// after that every enemy finds out whether it sees the player with a single bit test.
+class VisibilityField
+{
+public:
+	// Collects the cells again if the target cell or the room changed since the last update
+	void update(const Room& room, ivec2 target);
+
+	// True if the cell inside the room grid sees the target
+	bool visible_from(ivec2 cell) const { return cells.test(cell.y * room_grid_size + cell.x); }
+
+private:
+	ivec2 target = { -1, -1 };
+	unsigned int room_version = 0;
+	std::bitset<room_cell_count> cells;
+};
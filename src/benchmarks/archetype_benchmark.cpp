@@ -0,0 +1,134 @@
+// Micro-benchmark of the packed projectile rows (PackedGroup, see ECSRegistry::projectile_rows)
+// Runs the per-frame projectile passes (lifetime, movement) over 10k+ bullets stored in ComponentContainers
+// that were filled and emptied in between other entities, like after some time of play
+// (a) with packing disabled: each() walks the projectiles and looks every motion up in its own ordering
+// (b) with the rows packed: the projectile and motion of a bullet sit at the same position in both containers.
+// Build with -DVOID_BUILD_BENCHMARKS=ON and run ./void_archetype_benchmark
+// For hardware cache-miss counts run it under: perf stat -e cache-references,cache-misses
+
+// stdlib
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+// internal
+#include "ecs/ecs.hpp"
+#include "ecs/ecs_group.hpp"
+
+// Stand-ins with the sizes of the game components, the benchmark only needs the memory layout
+struct BenchMotion
+{
+	float position[2] = { 0, 0 };
+	float velocity[2] = { 1, 1 };
+	float scale[2] = { 16, 16 };
+	float previous_position[2] = { 0, 0 };
+	float previous_look_angle = 0;
+	float look_angle = 0;
+	bool complex = false;
+	bool is_moving[4] = { false, false, false, false };
+	float rates[5] = { 0, 0, 0, 0, 0 };
+	bool is_passable = false;
+	bool fast = false;
+	unsigned int collision_layer = 1;
+	unsigned int collision_mask = ~0u;
+};
+
+struct BenchProjectile
+{
+	Entity source = Entity::null();
+	int weapon_type = 0;
+	float lifetime = 1000.f;
+	float extra[4] = { 0, 0, 0, 0 };
+};
+
+using bench_clock = std::chrono::high_resolution_clock;
+
+struct BenchRegistry
+{
+	ComponentContainer<BenchProjectile> projectiles;
+	ComponentContainer<BenchMotion> motions;
+	PackedGroup<BenchProjectile, BenchMotion> projectile_rows{ &projectiles, &motions };
+};
+
+// Per-frame work of the game on bullets: lifetime countdown and movement
+static float frame(BenchRegistry& r, float step_ms)
+{
+	float checksum = 0;
+	r.projectile_rows.each([&](Entity, BenchProjectile& projectile, BenchMotion& motion) {
+		projectile.lifetime -= step_ms;
+		motion.position[0] += motion.velocity[0] * step_ms;
+		motion.position[1] += motion.velocity[1] * step_ms;
+		checksum += projectile.lifetime + motion.position[0];
+	});
+	return checksum;
+}
+
+// Spawns bullets between other moving entities and despawns a random part of both again
+static void fill(BenchRegistry& r, unsigned int count, std::default_random_engine& rng)
+{
+	std::vector<Entity> bullets;
+	std::vector<Entity> others;
+	for (unsigned int i = 0; i < count * 2; i++)
+	{
+		Entity other;
+		r.motions.insert(other, BenchMotion());
+		others.push_back(other);
+
+		Entity e;
+		r.motions.insert(e, BenchMotion());
+		r.projectiles.insert(e, BenchProjectile());
+		bullets.push_back(e);
+	}
+	std::shuffle(bullets.begin(), bullets.end(), rng);
+	std::shuffle(others.begin(), others.end(), rng);
+	for (unsigned int i = count; i < bullets.size(); i++)
+	{
+		r.motions.remove(bullets[i]);
+		r.projectiles.remove(bullets[i]);
+		r.motions.remove(others[i]);
+	}
+}
+
+int main()
+{
+	const int frames = 100;
+	const float step_ms = 1000.f / 120.f;
+	const unsigned int counts[] = { 10000, 20000, 50000 };
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "bullets   unpacked(ns/bullet)     packed(ns/bullet)  speedup" << std::endl;
+	for (unsigned int count : counts)
+	{
+		// two registries with the same history, the second one packs its rows at the sync point
+		std::default_random_engine rng_unpacked(count), rng_packed(count);
+		BenchRegistry unpacked, packed;
+		unpacked.projectile_rows.set_enabled(false);
+		fill(unpacked, count, rng_unpacked);
+		fill(packed, count, rng_packed);
+		packed.projectile_rows.pack();
+
+		float checksum_unpacked = 0;
+		auto start = bench_clock::now();
+		for (int f = 0; f < frames; f++)
+			checksum_unpacked += frame(unpacked, step_ms);
+		float unpacked_ns = std::chrono::duration<float, std::nano>(bench_clock::now() - start).count() / (frames * count);
+
+		float checksum_packed = 0;
+		start = bench_clock::now();
+		for (int f = 0; f < frames; f++)
+			checksum_packed += frame(packed, step_ms);
+		float packed_ns = std::chrono::duration<float, std::nano>(bench_clock::now() - start).count() / (frames * count);
+
+		// the bullets are visited in another order, so the float sums only agree up to rounding
+		bool agree = packed.projectile_rows.size() == count && unpacked.projectile_rows.size() == 0
+			&& std::abs(checksum_packed - checksum_unpacked) <= 1e-3f * std::abs(checksum_unpacked);
+		if (!agree)
+			std::cerr << "Storages disagree for " << count << " bullets" << std::endl;
+
+		std::cout << std::setw(7) << count << std::setw(22) << unpacked_ns << std::setw(22) << packed_ns
+			<< std::setw(9) << unpacked_ns / packed_ns << "x" << std::endl;
+	}
+	return 0;
+}
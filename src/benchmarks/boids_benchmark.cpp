@@ -0,0 +1,133 @@
+// Micro-benchmark of the neighbor sums of the boids steering
+// 256/1k/4k agents spread over the room, each sums up its separation (150px) and alignment (200px) neighbors
+// (a) against every other agent, the way handleBoidMovement used to
+// (b) with NeighborGrid::sums_within, the kernel the batched AISystem::steerBoids uses.
+// Build with -DVOID_BUILD_BENCHMARKS=ON and run ./void_boids_benchmark for the SSE kernel,
+// ./void_boids_benchmark_scalar for the scalar fallback of the same code
+
+// stdlib
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+// internal
+#include "ai_system/neighbor_grid.hpp"
+
+using bench_clock = std::chrono::high_resolution_clock;
+
+const float separation_distance = 150.f;
+const float alignment_distance = 200.f;
+
+// steering input of every agent, summed over all agents so the work cannot be optimized away
+struct Totals
+{
+	vec2 separation = { 0, 0 };
+	vec2 alignment = { 0, 0 };
+	int neighbors = 0;
+};
+
+// Same sums as NeighborGrid::sums_within, over every agent
+static NeighborGrid::Sums sums_all_pairs(const std::vector<NeighborGrid::Point>& agents, vec2 position, float radius)
+{
+	NeighborGrid::Sums sums;
+	for (const NeighborGrid::Point& other : agents)
+	{
+		vec2 offset = position - other.position;
+		if (dot(offset, offset) < radius * radius)
+		{
+			sums.offset += offset;
+			sums.velocity += other.velocity;
+			sums.count++;
+		}
+	}
+	return sums;
+}
+
+static Totals sum_all_pairs(const std::vector<NeighborGrid::Point>& agents)
+{
+	Totals totals;
+	for (const NeighborGrid::Point& agent : agents)
+	{
+		totals.separation += sums_all_pairs(agents, agent.position, separation_distance).offset;
+		NeighborGrid::Sums flock = sums_all_pairs(agents, agent.position, alignment_distance);
+		totals.alignment += flock.velocity - agent.velocity;
+		totals.neighbors += flock.count - 1;
+	}
+	return totals;
+}
+
+static Totals sum_grid(const NeighborGrid& grid, const std::vector<NeighborGrid::Point>& agents)
+{
+	Totals totals;
+	for (const NeighborGrid::Point& agent : agents)
+	{
+		totals.separation += grid.sums_within(agent.position, separation_distance).offset;
+		NeighborGrid::Sums flock = grid.sums_within(agent.position, alignment_distance);
+		totals.alignment += flock.velocity - agent.velocity;
+		totals.neighbors += flock.count - 1;
+	}
+	return totals;
+}
+
+// Compares the sums of every agent, the float sums of the two only differ by the order they are added in
+static bool sums_agree(const NeighborGrid& grid, const std::vector<NeighborGrid::Point>& agents)
+{
+	for (const NeighborGrid::Point& agent : agents)
+	{
+		NeighborGrid::Sums expected = sums_all_pairs(agents, agent.position, alignment_distance);
+		NeighborGrid::Sums sums = grid.sums_within(agent.position, alignment_distance);
+		float tolerance = 1e-4f * alignment_distance * expected.count;
+		if (sums.count != expected.count || length(sums.offset - expected.offset) > tolerance
+			|| length(sums.velocity - expected.velocity) > tolerance)
+			return false;
+	}
+	return true;
+}
+
+int main()
+{
+	const unsigned int counts[] = { 256, 1024, 4096 };
+	const int frames = 20;
+
+#ifdef NEIGHBOR_GRID_NO_SSE
+	std::cout << "neighbor sums: scalar" << std::endl;
+#else
+	std::cout << "neighbor sums: SSE where available" << std::endl;
+#endif
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << " agents  all pairs(us/frame)     grid(us/frame)  speedup" << std::endl;
+	for (unsigned int count : counts)
+	{
+		std::default_random_engine rng(count);
+		std::uniform_real_distribution<float> in_room_x(480.f + game_window_block_size, 1440.f - game_window_block_size);
+		std::uniform_real_distribution<float> in_room_y(32.f + game_window_block_size, 992.f - game_window_block_size);
+		std::uniform_real_distribution<float> velocity(-200.f, 200.f);
+
+		std::vector<NeighborGrid::Point> agents;
+		for (unsigned int i = 0; i < count; i++)
+			agents.push_back({ { in_room_x(rng), in_room_y(rng) }, { velocity(rng), velocity(rng) } });
+		NeighborGrid grid;
+		grid.build(agents);
+
+		Totals all_pairs;
+		auto start = bench_clock::now();
+		for (int frame = 0; frame < frames; frame++)
+			all_pairs = sum_all_pairs(agents);
+		float all_pairs_us = std::chrono::duration<float, std::micro>(bench_clock::now() - start).count() / frames;
+
+		Totals in_grid;
+		start = bench_clock::now();
+		for (int frame = 0; frame < frames; frame++)
+			in_grid = sum_grid(grid, agents);
+		float grid_us = std::chrono::duration<float, std::micro>(bench_clock::now() - start).count() / frames;
+
+		if (all_pairs.neighbors != in_grid.neighbors || !sums_agree(grid, agents))
+			std::cerr << "Neighbor sums disagree for " << count << " agents" << std::endl;
+
+		std::cout << std::setw(7) << count << std::setw(21) << all_pairs_us << std::setw(19) << grid_us
+			<< std::setw(9) << all_pairs_us / grid_us << "x" << std::endl;
+	}
+	return 0;
+}
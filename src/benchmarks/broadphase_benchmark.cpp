@@ -0,0 +1,95 @@
+// Micro-benchmark of the collision broadphase
+// A room scene with the 15x15 obstacle layout border, a player, enemies and 1k/5k/20k projectiles.
+// Compares the previous all-pairs AABB loop against the uniform grid in PhysicsSystem.
+// Build with -DVOID_BUILD_BENCHMARKS=ON and run ./void_broadphase_benchmark
+
+// stdlib
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+// internal
+#include "physics_system/spatial_grid.hpp"
+
+using bench_clock = std::chrono::high_resolution_clock;
+
+static SpatialGrid::Box box_at(vec2 position, vec2 scale)
+{
+	return { position - 0.5f * scale, position + 0.5f * scale };
+}
+
+static bool overlaps(const SpatialGrid::Box& b1, const SpatialGrid::Box& b2)
+{
+	return b1.min.x < b2.max.x && b2.min.x < b1.max.x && b1.min.y < b2.max.y && b2.min.y < b1.max.y;
+}
+
+static std::vector<SpatialGrid::Box> make_scene(unsigned int projectile_count, std::default_random_engine& rng)
+{
+	const vec2 room_min = { 480.f, 32.f };
+	std::uniform_real_distribution<float> in_room(game_window_block_size, game_window_size_px - game_window_block_size);
+	std::vector<SpatialGrid::Box> boxes;
+
+	// walls around the room and a few obstacles inside
+	for (int i = 0; i < 15; i++)
+	{
+		boxes.push_back(box_at(room_min + vec2(i * 64 + 32, 32), vec2(64, 64)));
+		boxes.push_back(box_at(room_min + vec2(i * 64 + 32, 14 * 64 + 32), vec2(64, 64)));
+		boxes.push_back(box_at(room_min + vec2(32, i * 64 + 32), vec2(64, 64)));
+		boxes.push_back(box_at(room_min + vec2(14 * 64 + 32, i * 64 + 32), vec2(64, 64)));
+	}
+	for (int i = 0; i < 20; i++)
+		boxes.push_back(box_at(room_min + vec2(in_room(rng), in_room(rng)), vec2(64, 64)));
+
+	// player and enemies
+	boxes.push_back(box_at(room_min + vec2(480, 480), vec2(64, 64)));
+	for (int i = 0; i < 30; i++)
+		boxes.push_back(box_at(room_min + vec2(in_room(rng), in_room(rng)), vec2(64, 64)));
+
+	for (unsigned int i = 0; i < projectile_count; i++)
+		boxes.push_back(box_at(room_min + vec2(in_room(rng), in_room(rng)), vec2(16, 16)));
+	return boxes;
+}
+
+int main()
+{
+	const unsigned int counts[] = { 1000, 5000, 20000 };
+	const int frames = 10;
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "projectiles   all-pairs(ms)   grid(ms)   pairs" << std::endl;
+	for (unsigned int count : counts)
+	{
+		std::default_random_engine rng(count);
+		std::vector<SpatialGrid::Box> boxes = make_scene(count, rng);
+
+		unsigned int brute_pairs = 0;
+		auto start = bench_clock::now();
+		for (int frame = 0; frame < frames; frame++)
+		{
+			brute_pairs = 0;
+			for (unsigned int i = 0; i < boxes.size(); i++)
+				for (unsigned int j = i + 1; j < boxes.size(); j++)
+					if (overlaps(boxes[i], boxes[j]))
+						brute_pairs++;
+		}
+		float brute_ms = std::chrono::duration<float, std::milli>(bench_clock::now() - start).count() / frames;
+
+		SpatialGrid grid;
+		unsigned int grid_pairs = 0;
+		start = bench_clock::now();
+		for (int frame = 0; frame < frames; frame++)
+		{
+			grid_pairs = 0;
+			grid.build(boxes);
+			grid.for_each_pair([&grid_pairs](unsigned int, unsigned int) { grid_pairs++; });
+		}
+		float grid_ms = std::chrono::duration<float, std::milli>(bench_clock::now() - start).count() / frames;
+
+		if (brute_pairs != grid_pairs)
+			std::cerr << "Broadphases disagree for " << count << " projectiles: " << brute_pairs << " vs " << grid_pairs << std::endl;
+
+		std::cout << std::setw(11) << count << std::setw(16) << brute_ms << std::setw(11) << grid_ms << std::setw(8) << grid_pairs << std::endl;
+	}
+	return 0;
+}
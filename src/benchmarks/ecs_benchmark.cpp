@@ -0,0 +1,151 @@
+// Micro-benchmark of the ECS component container
+// Compares the sparse-set ComponentContainer against the previous unordered_map based lookup
+// with the access pattern of a room full of projectiles: spawn, per frame get/has, despawn.
+// Build with -DVOID_BUILD_BENCHMARKS=ON and run ./void_ecs_benchmark
+
+// stdlib
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+// internal
+#include "ecs/ecs.hpp"
+
+// Same size as the hot part of Motion
+struct BenchMotion
+{
+	float position[2] = { 0, 0 };
+	float velocity[2] = { 1, 1 };
+	float scale[2] = { 16, 16 };
+	float angle = 0;
+};
+
+// The previous ComponentContainer, reduced to the operations measured here
+template <typename Component>
+class MapComponentContainer
+{
+	std::unordered_map<unsigned int, unsigned int> map_entity_componentID;
+public:
+	std::vector<Component> components;
+	std::vector<Entity> entities;
+
+	Component& insert(Entity e, Component c)
+	{
+		map_entity_componentID[e] = (unsigned int)components.size();
+		components.push_back(std::move(c));
+		entities.push_back(e);
+		return components.back();
+	}
+
+	Component& get(Entity e) { return components[map_entity_componentID[e]]; }
+
+	bool has(Entity entity) { return map_entity_componentID.count(entity) > 0; }
+
+	void remove(Entity e)
+	{
+		if (has(e))
+		{
+			int cID = map_entity_componentID[e];
+			components[cID] = std::move(components.back());
+			entities[cID] = entities.back();
+			map_entity_componentID[entities.back()] = cID;
+			map_entity_componentID.erase(e);
+			components.pop_back();
+			entities.pop_back();
+		}
+	}
+};
+
+using bench_clock = std::chrono::high_resolution_clock;
+
+static float elapsed_ms(bench_clock::time_point start)
+{
+	return std::chrono::duration<float, std::milli>(bench_clock::now() - start).count();
+}
+
+struct BenchResult
+{
+	float insert_ms = 0;
+	float frame_ms = 0;
+	float remove_ms = 0;
+	float checksum = 0;
+};
+
+// Spawns n projectiles, runs a number of frames that look every projectile up by entity (get) and
+// probe a second container for a flag (has, about half hit), then removes them in random order
+template <class Container>
+static BenchResult run_projectiles(const std::vector<Entity>& projectiles, int frames, unsigned int seed)
+{
+	BenchResult result;
+	Container motions;
+	Container flags;
+
+	auto start = bench_clock::now();
+	for (unsigned int i = 0; i < projectiles.size(); i++)
+	{
+		motions.insert(projectiles[i], BenchMotion());
+		if (i % 2 == 0)
+			flags.insert(projectiles[i], BenchMotion());
+	}
+	result.insert_ms = elapsed_ms(start);
+
+	start = bench_clock::now();
+	for (int frame = 0; frame < frames; frame++)
+	{
+		for (Entity e : projectiles)
+		{
+			if (flags.has(e))
+				continue;
+			BenchMotion& motion = motions.get(e);
+			motion.position[0] += motion.velocity[0];
+			motion.position[1] += motion.velocity[1];
+		}
+	}
+	result.frame_ms = elapsed_ms(start) / frames;
+
+	std::vector<Entity> removal_order = projectiles;
+	std::shuffle(removal_order.begin(), removal_order.end(), std::default_random_engine(seed));
+	for (unsigned int i = 0; i < removal_order.size() / 2; i++)
+		result.checksum += motions.get(removal_order[i]).position[0];
+
+	start = bench_clock::now();
+	for (Entity e : removal_order)
+	{
+		motions.remove(e);
+		flags.remove(e);
+	}
+	result.remove_ms = elapsed_ms(start);
+	return result;
+}
+
+int main()
+{
+	const int frames = 60;
+	const unsigned int counts[] = { 5000, 10000, 20000, 50000 };
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "container      count   insert(ms)  frame(ms)  remove(ms)" << std::endl;
+	for (unsigned int count : counts)
+	{
+		// Interleave with other entities so projectile ids are not contiguous, like in a running game
+		std::vector<Entity> projectiles;
+		projectiles.reserve(count);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			Entity other;
+			projectiles.push_back(Entity());
+		}
+
+		BenchResult map_result = run_projectiles<MapComponentContainer<BenchMotion>>(projectiles, frames, count);
+		BenchResult sparse_result = run_projectiles<ComponentContainer<BenchMotion>>(projectiles, frames, count);
+		if (map_result.checksum != sparse_result.checksum)
+			std::cerr << "Containers disagree for " << count << " projectiles" << std::endl;
+
+		std::cout << "unordered_map " << std::setw(7) << count << std::setw(12) << map_result.insert_ms
+			<< std::setw(11) << map_result.frame_ms << std::setw(12) << map_result.remove_ms << std::endl;
+		std::cout << "sparse set    " << std::setw(7) << count << std::setw(12) << sparse_result.insert_ms
+			<< std::setw(11) << sparse_result.frame_ms << std::setw(12) << sparse_result.remove_ms << std::endl;
+	}
+	return 0;
+}
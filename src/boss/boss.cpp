@@ -3,6 +3,8 @@
 #include <world_system/world_system.hpp>
 #include <world_init/world_init.hpp>
 #include <components/components.hpp>
+#include <random_service/random_service.hpp>
+#include <profiler/profiler.hpp>
 #include <queue> // For priority queue (open list)
 #include <unordered_set>  
 #include <algorithm> 
@@ -24,6 +26,7 @@ const float halfCellSize = cellSize / 2.0f;
 
 void Boss::step(float elapsed_ms)
 {
+    PROFILE_SCOPE("boss.step");
     auto& bossesRegistry = registry.bosses;
     for (uint i = 0; i < bossesRegistry.size(); i++)
     {
@@ -186,7 +189,7 @@ void Boss::handleOffensiveState(Entity entity, BossAI& boss, Motion& motion, flo
     }
    
     int maxEnemies = 5; // Maximum number of enemies that can be alive at once
-    auto enemyType = enemy_types[rand() % enemy_types.size()]; // Random type from predefined vector
+    auto enemyType = enemy_types[random_service.range(RANDOM_STREAM::AI, 0, enemy_types.size() - 1)]; // Random type from predefined vector
     if (boss.enemyCreationTimer >= boss.enemyCreationCooldown && boss.totalSpawnedEnemies < maxEnemies) {
         boss.enemyCreationTimer = 0.0f; // Reset timer for next enemy creation
         createEnemy(renderer, vec2(motion.position.x, motion.position.y), 500.0f, enemyType, true);
@@ -217,8 +220,8 @@ void Boss::handleGuidedMissile(Entity entity, BossAI& boss, Motion& motion, floa
 }
 
 void Boss::updateGuidedMissiles(float elapsed_ms) {
-    for (auto& missileEntity : registry.guidedMissiles.entities) { // Assuming you have a way to track guided missile entities
-        Motion& missileMotion = registry.motions.get(missileEntity);
+    PROFILE_SCOPE("boss.updateGuidedMissiles");
+    view_of(registry.guidedMissiles, registry.motions).each([&](Entity, Projectile&, Motion& missileMotion) {
         Entity targetEntity = registry.players.entities[0]; // Assuming the player is the target
         Motion& targetMotion = registry.motions.get(targetEntity);
         // Calculate the direction to the target
@@ -230,7 +233,7 @@ void Boss::updateGuidedMissiles(float elapsed_ms) {
 
         // in our case 180 degrees is added to the angle to make it face the right direction
         missileMotion.look_angle = atan2(missileMotion.velocity.y, missileMotion.velocity.x) + M_PI;
-    }
+    });
 }
 
 vec2 Boss:: lerp(const glm::vec2& a, const glm::vec2& b, float t) {
@@ -40,7 +40,12 @@ const int window_height_px = 1024;
 const int game_window_size_px = 960;
 // game window block size, width and height
 const int game_window_block_size = 64;
+// rooms are a grid of room_grid_size x room_grid_size blocks
+const int room_grid_size = game_window_size_px / game_window_block_size;
+const int room_cell_count = room_grid_size * room_grid_size;
 const float aspect_ratio = (float)window_width_px / (float)window_height_px;
+// the simulation always advances in steps of this length, see the main loop
+const float simulation_step_ms = 1000.f / 120.f;
 
 // Colors
 const vec3 COLOR_WHITE = vec3(1.0f, 1.0f, 1.0f);
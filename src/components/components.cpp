@@ -11,6 +11,68 @@
 Debug debugging;
 float death_timer_counter_ms = 3000;
 
+// Bresenham's line from one cell to the other, false if a cell on the way (both ends included) is an obstacle
+static bool walk_line(const Room& room, ivec2 from, ivec2 to)
+{
+	int dx = abs(to.x - from.x);
+	int sx = from.x < to.x ? 1 : -1;
+	int dy = -abs(to.y - from.y);
+	int sy = from.y < to.y ? 1 : -1;
+	int err = dx + dy;
+
+	while (true) {
+		if (room.is_obstacle(from))
+			return false;
+		if (from == to)
+			return true;
+
+		int e2 = 2 * err;
+		if (e2 >= dy) {
+			err += dy;
+			from.x += sx;
+		}
+		if (e2 <= dx) {
+			err += dx;
+			from.y += sy;
+		}
+	}
+}
+
+void Room::build_occupancy()
+{
+	static unsigned int versions = 0;
+	occupancy_version = ++versions;
+
+	occupancy.reset();
+	for (const vec2& pos : obstacle_positions) {
+		ivec2 cell = ivec2(pos);
+		if (in_room_grid(cell))
+			occupancy.set(cell.y * room_grid_size + cell.x);
+	}
+
+	visibility.assign(room_cell_count, std::bitset<room_cell_count>());
+	for (int from = 0; from < room_cell_count; from++) {
+		ivec2 from_cell = { from % room_grid_size, from / room_grid_size };
+		for (int to = 0; to < room_cell_count; to++) {
+			if (walk_line(*this, from_cell, { to % room_grid_size, to / room_grid_size }))
+				visibility[from].set(to);
+		}
+	}
+}
+
+bool Room::is_obstacle(ivec2 cell) const
+{
+	return in_room_grid(cell) && occupancy.test(cell.y * room_grid_size + cell.x);
+}
+
+bool Room::line_of_sight(ivec2 from, ivec2 to) const
+{
+	// lines that leave the room are walked, the table only covers the cells inside
+	if (visibility.empty() || !in_room_grid(from) || !in_room_grid(to))
+		return walk_line(*this, from, to);
+	return visibility[from.y * room_grid_size + from.x].test(to.y * room_grid_size + to.x);
+}
+
 // Very, VERY simple OBJ loader from https://github.com/opengl-tutorials/ogl tutorial 7
 // (modified to also read vertex color and omit uv and normals)
 bool Mesh::loadFromOBJFile(std::string obj_path, std::vector<ColoredVertex>& out_vertices, std::vector<uint16_t>& out_vertex_indices, vec2& out_size)
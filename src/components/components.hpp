@@ -1,4 +1,6 @@
 #pragma once
+#include <bitset>
+#include <climits>
 #include <iostream>
 #include <map>
 
@@ -69,6 +71,12 @@ enum class ROOM_TYPE {
 	SHOP_ROOM = BOSS_ROOM + 1
 };
 
+// whether a cell is inside the room_grid_size x room_grid_size room grid
+inline bool in_room_grid(ivec2 cell)
+{
+	return cell.x >= 0 && cell.x < room_grid_size && cell.y >= 0 && cell.y < room_grid_size;
+}
+
 // All data relevant to the contents of a game room
 struct Room {
 
@@ -101,6 +109,19 @@ struct Room {
 	// the positions of the obstacles in the room
 	std::set<vec2, vec2comp> obstacle_positions;
 
+	// cells of the room grid that hold an obstacle, indexed y * room_grid_size + x
+	std::bitset<room_cell_count> occupancy;
+	// visibility[from] has the bit of every cell the Bresenham line from 'from' reaches without obstacles
+	std::vector<std::bitset<room_cell_count>> visibility;
+	// changes every time the grid is built, so cached paths can tell the obstacles changed
+	unsigned int occupancy_version = 0;
+
+	// builds occupancy and visibility from obstacle_positions, done when the room is entered
+	void build_occupancy();
+	// cells outside of the room never hold an obstacle
+	bool is_obstacle(ivec2 cell) const;
+	bool line_of_sight(ivec2 from, ivec2 to) const;
+
 	WeaponType weapon_on_sale = WeaponType::TOTAL_WEAPON_TYPES;
 
 	// The number of powerups in the room
@@ -199,7 +220,7 @@ struct Player
 struct Projectile
 {
 	float lifetime = 0.0f;	// time before the projectile disappears
-	Entity source; // New attribute to store the source entity of the projectile
+	Entity source = Entity::null(); // New attribute to store the source entity of the projectile
 	WeaponType weapon_type;
 };
 
@@ -210,13 +231,13 @@ struct OnFireTimer
 	float counter_ms = 2000.0f;
 	float total_time_ms = 2000.0f;
 
-	Entity fire;
+	Entity fire = Entity::null();
 };
 
 struct MuzzleFlashTimer
 {
 	float counter_ms = 0.0f;
-	Entity source;
+	Entity source = Entity::null();
 };
 
 // Obstacle component
@@ -252,8 +273,11 @@ struct AI
 	float safe_distance = 150.0f; // the distance that the AI will start behaving from the player
 	float attack_distance = 100.0f; // the distance that the AI will start attacking the player
 	float shootingCooldown = 0.0f; // time in seconds before the next shot can be made for ranged enemies
-	int frequency = 0; // frequency of think cycles
-	int counter = 0; // counter for think cycles
+	int frequency = 0; // AI steps between think cycles
+	int counter = 0; // AI steps until the next think cycle is due
+	// decisions of the last think cycle, the steering uses them every step
+	bool sees_player = false; // line of sight to the player
+	vec2 waypoint = { 0, 0 }; // where to go to get closer to the player when it is not in sight
 	bool in_boss_room = false; // if the AI is in a boss room
 };
 
@@ -299,13 +323,32 @@ struct Shield
 	float recharge_delay = 0.0f; // delay before the shield starts recharging
 };
 
+// Collision layer bits used by Motion::collision_layer and Motion::collision_mask.
+// The physics system only checks a pair if each entity's layer is in the other's mask.
+namespace COLLISION_LAYER {
+	enum : unsigned int {
+		NONE = 0,
+		DEFAULT = 1 << 0, // entities not assigned to a layer, collide with everything
+		PLAYER = 1 << 1,
+		ENEMY = 1 << 2,
+		PLAYER_PROJECTILE = 1 << 3,
+		ENEMY_PROJECTILE = 1 << 4,
+		OBSTACLE = 1 << 5,
+		PICKUP = 1 << 6,
+		UI = 1 << 7, // HUD, menus and visual effects, never collide
+		ALL = ~0u
+	};
+}
+
 // All data relevant to the shape and motion of entities
 struct Motion {
 	vec2 position = { 0, 0 };
 	vec2 velocity = { 0, 0 };
 	vec2 scale = { 10, 10 };
 
+	// pose at the start of the last physics step, rendering interpolates from it
 	vec2 previous_position = {-1, -1};
+	float previous_look_angle = 0;
 
 	float look_angle = 0; // angle the entity is looking at
 
@@ -323,17 +366,24 @@ struct Motion {
 	float turn_speed = 0.0f;		// how fast the entity is currently turning
 
 	bool is_passable = false; // if the entity is passable (cannot be collided with)
+	bool fast = false; // if the entity can move past other entities in one step, collisions are swept from previous_position
+
+	unsigned int collision_layer = COLLISION_LAYER::DEFAULT; // layer bit of the entity, see set_collision_layer
+	unsigned int collision_mask = COLLISION_LAYER::ALL; // layers the entity can collide with
 };
 
 // Stucture to store collision information
 struct Collision
 {
 	// Note, the first object is stored in the ECS container.entities
-	Entity other; // the second object involved in the collision
+	Entity other = Entity::null(); // the second object involved in the collision
 	Collision(Entity& other) { this->other = other; };
 
-	// Scalar of the displacement vector
-	float scalar;
+	// Minimum translation vector, moving the first object by normal * depth separates it from the other
+	vec2 normal = { 0, 0 };
+	float depth = 0.f;
+	// position of the first object when the collision was found, tells how much of the depth is already resolved
+	vec2 position = { 0, 0 };
 };
 
 // Data structure for toggling debug mode
@@ -342,6 +392,7 @@ struct Debug
 	bool in_debug_mode = 0;
 	bool in_freeze_mode = 0;
 	bool show_fps = 0;
+	bool show_profiler = 0;
 };
 extern Debug debugging;
 
@@ -424,7 +475,7 @@ struct Character {
 };
 
 struct Button {
-	Entity text_entity;
+	Entity text_entity = Entity::null();
 	bool hover = false;	
 	bool disabled = false;
 	std::function<void()> on_click = []() {};
@@ -589,7 +640,8 @@ enum class EFFECT_ASSET_ID {
 	TEXTURED = COLOURED + 1,
 	POST_PROCESS = TEXTURED + 1,
 	LINE = POST_PROCESS + 1,
-	EFFECT_COUNT = LINE + 1
+	SPRITE_BATCH = LINE + 1,
+	EFFECT_COUNT = SPRITE_BATCH + 1
 };
 const int effect_count = (int)EFFECT_ASSET_ID::EFFECT_COUNT;
 
@@ -2,4 +2,40 @@
 #include "ecs/ecs.hpp"
 
 // All we need to store besides the containers is the id of every entity and callbacks to be able to remove entities across containers
-unsigned int Entity::id_count = 1;
\ No newline at end of file
+unsigned int Entity::id_count = 1;
+std::deque<unsigned int> Entity::free_indices;
+std::vector<unsigned short> Entity::generations;
+
+constexpr unsigned int Entity::index_bits;
+constexpr unsigned int Entity::index_mask;
+constexpr unsigned int Entity::max_generation;
+
+// Keep a few released indices around before re-using them, so an index runs through its generations more slowly
+static const size_t min_free_indices = 1024;
+
+Entity::Entity()
+{
+	unsigned int index;
+	if (free_indices.size() > min_free_indices)
+	{
+		index = free_indices.front();
+		free_indices.pop_front();
+	}
+	else
+	{
+		index = id_count++;
+		assert(index <= index_mask && "Ran out of entity indices");
+		generations.resize(index + 1, 0);
+	}
+	id = ((unsigned int)generations[index] << index_bits) | index;
+}
+
+void Entity::release(Entity e)
+{
+	if (!e.is_alive())
+		return;
+	generations[e.index()]++;
+	// past the last generation the index is retired, re-using it would give handles of the first generation again
+	if (generations[e.index()] <= max_generation)
+		free_indices.push_back(e.index());
+}
@@ -8,19 +8,47 @@
 #include <typeindex>
 #include <assert.h>
 #include <memory>
+#include <limits>
+#include <deque>
 
 // Unique identifyer for all entities
+// The id packs an index (low bits) and a generation (high bits). Indices of destroyed entities are
+// re-used, the generation is bumped every time so that old handles to that index can be detected.
+// An index whose generation has run through all values is retired instead of wrapping around,
+// so a stale handle never matches a live entity.
 class Entity
 {
 	unsigned int id;
 	static unsigned int id_count; // starts from 1, entit 0 is the default initialization
+	static std::deque<unsigned int> free_indices; // released indices, re-used oldest first
+	static std::vector<unsigned short> generations; // current generation of every index
+
+	explicit Entity(unsigned int raw_id) : id(raw_id) {}
 public:
-	Entity()
+	static constexpr unsigned int index_bits = 20;
+	static constexpr unsigned int index_mask = (1u << index_bits) - 1;
+	static constexpr unsigned int max_generation = (1u << (32 - index_bits)) - 1;
+
+	Entity();
+
+	// A handle that refers to no entity and does not take up an index, for members that are assigned later
+	static Entity null() { return Entity(0u); }
+
+	// Mark the entity as destroyed and its index for re-use, all existing handles to it become stale.
+	// Releasing a stale handle does nothing, so destroying an entity twice is safe.
+	static void release(Entity e);
+
+	// False for stale handles of destroyed entities and for Entity::null()
+	bool is_alive() const
 	{
-		id = id_count++;
-		// Note, indices of already deleted entities arent re-used in this simple implementation.
+		const unsigned int i = index();
+		return i != 0 && i < generations.size() && generations[i] == generation();
 	}
-	operator unsigned int() { return id; } // this enables automatic casting to int
+
+	unsigned int index() const { return id & index_mask; }
+	unsigned int generation() const { return id >> index_bits; }
+
+	operator unsigned int() const { return id; } // this enables automatic casting to int
 };
 
 // Common interface to refer to all containers in the ECS registry
@@ -30,16 +58,51 @@ struct ContainerInterface
 	virtual size_t size() = 0;
 	virtual void remove(Entity e) = 0;
 	virtual bool has(Entity entity) = 0;
+	virtual void remove_batch(const std::vector<Entity>& batch) = 0;
+};
+
+// Keeps entities that have all of its components at the front of its containers, see PackedGroup.
+// The containers tell it before they remove components, so the packed rows stay contiguous.
+struct GroupInterface
+{
+	virtual void on_remove(Entity e) = 0;
+	virtual void on_clear() = 0;
 };
 
 // A container that stores components of type 'Component' and associated entities
+// Implemented as a sparse set: a paged sparse array indexed by entity id maps to
+// the position of the component in the densely packed components/entities vectors.
 template <typename Component> // A component can be any class
 class ComponentContainer : public ContainerInterface
 {
 private:
-	// The hash map from Entity -> array index.
-	std::unordered_map<unsigned int, unsigned int> map_entity_componentID; // the entity is cast to uint to be hashable.
+	// Number of entity ids covered by one sparse page, pages are only allocated once an id in their range is used
+	static constexpr unsigned int sparse_page_size = 1024;
+	// Marks an entity id that has no component in this container
+	static constexpr unsigned int invalid_index = std::numeric_limits<unsigned int>::max();
+
+	// The paged sparse array from Entity index -> array index. An empty page has no entries yet.
+	std::vector<std::vector<unsigned int>> sparse_pages;
 	bool registered = false;
+
+	// Look up the dense index of an entity index, invalid_index if it is not contained
+	inline unsigned int sparse_index(unsigned int id) const
+	{
+		const unsigned int page = id / sparse_page_size;
+		if (page >= sparse_pages.size() || sparse_pages[page].empty())
+			return invalid_index;
+		return sparse_pages[page][id % sparse_page_size];
+	}
+
+	inline void set_sparse_index(unsigned int id, unsigned int index)
+	{
+		const unsigned int page = id / sparse_page_size;
+		if (page >= sparse_pages.size())
+			sparse_pages.resize(page + 1);
+		if (sparse_pages[page].empty())
+			sparse_pages[page].assign(sparse_page_size, invalid_index);
+		sparse_pages[page][id % sparse_page_size] = index;
+	}
 public:
 	// Container of all components of type 'Component'
 	std::vector<Component> components;
@@ -52,13 +115,17 @@ public:
 	{
 	}
 
+	// The group that packs this container, nullptr if it is not part of one
+	GroupInterface* group = nullptr;
+
 	// Inserting a component c associated to entity e
 	inline Component& insert(Entity e, Component c, bool check_for_duplicates = true)
 	{
 		// Usually, every entity should only have one instance of each component type
 		assert(!(check_for_duplicates && has(e)) && "Entity already contained in ECS registry");
 
-		map_entity_componentID[e] = (unsigned int)components.size();
+		// With duplicates the sparse entry points to the most recently inserted component
+		set_sparse_index(e.index(), (unsigned int)components.size());
 		components.push_back(std::move(c)); // the move enforces move instead of copy constructor
 		entities.push_back(e);
 		return components.back();
@@ -77,13 +144,37 @@ public:
 	// A wrapper to return the component of an entity
 	Component& get(Entity e) {
 		assert(has(e) && "Entity not contained in ECS registry");
-		return components[map_entity_componentID[e]];
+		return components[sparse_index(e.index())];
 	};
 
 
+	// Returns the component of an entity or nullptr if it has none, a single lookup instead of has() and get()
+	Component* try_get(Entity e) {
+		const unsigned int cID = sparse_index(e.index());
+		return (cID != invalid_index && entities[cID] == e) ? &components[cID] : nullptr;
+	}
+
+	// Position of the component of an entity in the dense vectors
+	unsigned int index_of(Entity e) const {
+		return sparse_index(e.index());
+	}
+
+	// Exchange the components and entities at two positions of the dense vectors
+	void swap_entries(unsigned int a, unsigned int b)
+	{
+		if (a == b)
+			return;
+		std::swap(components[a], components[b]);
+		std::swap(entities[a], entities[b]);
+		set_sparse_index(entities[a].index(), a);
+		set_sparse_index(entities[b].index(), b);
+	}
+
 	// Check if entity has a component of type 'Component'
+	// A stale handle shares its index with a newer entity, so the stored entity is compared as well
 	bool has(Entity entity) {
-		return map_entity_componentID.count(entity) > 0;
+		const unsigned int cID = sparse_index(entity.index());
+		return cID != invalid_index && entities[cID] == entity;
 	}
 
 	// Remove an component and pack the container to re-use the empty space
@@ -91,27 +182,46 @@ public:
 	{
 		if (has(e))
 		{
+			// a packed entity leaves its group first, that moves it behind the packed rows
+			if (group)
+				group->on_remove(e);
+
 			// Get the current position
-			int cID = map_entity_componentID[e];
+			unsigned int cID = sparse_index(e.index());
+			const unsigned int last = (unsigned int)components.size() - 1;
 
 			// Move the last element to position cID using the move operator
 			// Note, components[cID] = components.back() would trigger the copy instead of move operator
 			components[cID] = std::move(components.back());
 			entities[cID] = entities.back(); // the entity is only a single index, copy it.
-			map_entity_componentID[entities.back()] = cID;
+			// Only re-point the moved entity if the sparse entry is its own (not a newer entity on the same index)
+			if (sparse_index(entities.back().index()) == last)
+				set_sparse_index(entities.back().index(), cID);
 
 			// Erase the old component and free its memory
-			map_entity_componentID.erase(e);
+			set_sparse_index(e.index(), invalid_index);
 			components.pop_back();
 			entities.pop_back();
-			// Note, one could mark the id for re-use
 		}
 	};
 
+	// Remove the components of several entities, used when destroying a batch of entities
+	void remove_batch(const std::vector<Entity>& batch)
+	{
+		if (components.empty())
+			return;
+		for (Entity e : batch)
+			ComponentContainer::remove(e); // qualified to avoid the virtual call per entity
+	}
+
 	// Remove all components of type 'Component'
 	void clear()
 	{
-		map_entity_componentID.clear();
+		if (group)
+			group->on_clear();
+		// Reset only the used entries, the allocated pages are kept for the next room
+		for (Entity e : entities)
+			set_sparse_index(e.index(), invalid_index);
 		components.clear();
 		entities.clear();
 	}
@@ -126,14 +236,31 @@ public:
 	template <class Compare>
 	void sort(Compare comparisonFunction)
 	{
-		// First sort the entity list as desired
-		std::sort(entities.begin(), entities.end(), comparisonFunction);
-		// Now re-arrange the components (Note, creates a new vector, which may be slow! Not sure if in-place could be faster: https://stackoverflow.com/questions/63703637/how-to-efficiently-permute-an-array-in-place-using-stdswap)
+		assert(!group && "Sorting would break the packed rows of the group");
+		// Sort a permutation of the dense indices, so duplicate entries of one entity are kept apart
+		std::vector<unsigned int> order(entities.size());
+		for (unsigned int i = 0; i < order.size(); i++)
+			order[i] = i;
+		std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) { return comparisonFunction(entities[a], entities[b]); });
+		// Now re-arrange both dense vectors (Note, creates new vectors, we use move operations to not create unneccesary copies of objects)
 		std::vector<Component> components_new; components_new.reserve(components.size());
-		std::transform(entities.begin(), entities.end(), std::back_inserter(components_new), [&](Entity e) { return std::move(get(e)); }); // note, the get still uses the old hash map (on purpose!)
-		components = std::move(components_new); // note, we use move operations to not create unneccesary copies of objects, but memory is still allocated for the new vector
-		// Fill the new hashmap
+		std::vector<Entity> entities_new; entities_new.reserve(entities.size());
+		for (unsigned int i : order)
+		{
+			components_new.push_back(std::move(components[i]));
+			entities_new.push_back(entities[i]);
+		}
+		components = std::move(components_new);
+		entities = std::move(entities_new);
+		// Fill the sparse array with the new positions, entries of destroyed entities must not take over a re-used index
 		for (unsigned int i = 0; i < entities.size(); i++)
-			map_entity_componentID[entities[i]] = i;
+			if (entities[i].is_alive())
+				set_sparse_index(entities[i].index(), i);
 	}
 };
+
+// Out of class definitions of the static members, needed when they are bound to a reference (e.g. by std::vector::assign)
+template <typename Component>
+constexpr unsigned int ComponentContainer<Component>::sparse_page_size;
+template <typename Component>
+constexpr unsigned int ComponentContainer<Component>::invalid_index;
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "ecs/ecs.hpp"
+
+// Records structural changes (destroying entities, adding and removing components) while a system
+// iterates the containers, and applies them together at a sync point with flush().
+// Destroys are coalesced per entity and removed container by container in one batch.
+class CommandBuffer
+{
+	std::vector<Entity> destroyed;
+	// Set for the index of every entity in 'destroyed', to skip duplicates and answer is_destroyed()
+	std::vector<bool> destroy_marks;
+	std::vector<std::function<void()>> component_commands;
+public:
+	// Destroy the entity at the next flush, recording the same entity twice is fine
+	void destroy(Entity e)
+	{
+		if (!e.is_alive() || is_destroyed(e))
+			return;
+		if (e.index() >= destroy_marks.size())
+			destroy_marks.resize(e.index() + 1, false);
+		destroy_marks[e.index()] = true;
+		destroyed.push_back(e);
+	}
+
+	// True if the entity is waiting to be destroyed at the next flush
+	bool is_destroyed(Entity e) const
+	{
+		return e.index() < destroy_marks.size() && destroy_marks[e.index()];
+	}
+
+	// Add the component at the next flush, unless the entity is gone or already has one
+	template <typename Component>
+	void add(ComponentContainer<Component>& container, Entity e, Component c)
+	{
+		component_commands.push_back([&container, e, c]() {
+			if (e.is_alive() && !container.has(e))
+				container.insert(e, c);
+		});
+	}
+
+	template <typename Component>
+	void remove(ComponentContainer<Component>& container, Entity e)
+	{
+		component_commands.push_back([&container, e]() { container.remove(e); });
+	}
+
+	bool empty() const
+	{
+		return destroyed.empty() && component_commands.empty();
+	}
+
+	// Apply all recorded commands, component changes in recorded order first and then the destroys
+	void flush(const std::vector<ContainerInterface*>& containers)
+	{
+		for (std::function<void()>& command : component_commands)
+			command();
+		component_commands.clear();
+
+		if (destroyed.empty())
+			return;
+		// one call per container for the whole batch, instead of one per container and entity
+		for (ContainerInterface* container : containers)
+			container->remove_batch(destroyed);
+		for (Entity e : destroyed)
+		{
+			destroy_marks[e.index()] = false;
+			Entity::release(e);
+		}
+		destroyed.clear();
+	}
+};
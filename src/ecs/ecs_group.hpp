@@ -0,0 +1,135 @@
+#pragma once
+
+#include <tuple>
+#include <utility>
+#include <initializer_list>
+
+#include "ecs/ecs.hpp"
+
+// Archetype storage mode for entities that share one component signature, e.g. the projectiles.
+// Every entity with all of the components is packed at the front of each container, at the same position in all
+// of them, so a pass over the group streams through the component vectors side by side (SoA) instead of looking
+// each component up in its own container. The registry keeps using the containers as before.
+// Rows are packed at the sync points (pack(), see ECSRegistry::flush_commands), so references taken while creating
+// an entity are never moved under the caller. Removing a component unpacks its row right away.
+// With packing disabled every row stays where its containers put it, and each() looks the components up instead.
+template <typename... Components>
+class PackedGroup : public GroupInterface
+{
+	std::tuple<ComponentContainer<Components>*...> containers;
+	// the rows at positions 0 .. count - 1 of every container belong to the group
+	unsigned int count = 0;
+	bool enabled = true;
+
+	static bool all_of(std::initializer_list<bool> values)
+	{
+		for (bool v : values)
+			if (!v)
+				return false;
+		return true;
+	}
+
+	template <size_t... I>
+	void attach(std::index_sequence<I...>)
+	{
+		int expand[] = { 0, (std::get<I>(containers)->group = this, 0)... };
+		(void)expand;
+	}
+
+	template <size_t... I>
+	bool complete(Entity e, std::index_sequence<I...>) const
+	{
+		return all_of({ std::get<I>(containers)->has(e)... });
+	}
+
+	// Moves the components of e to 'position' in every container
+	template <size_t... I>
+	void move_row(Entity e, unsigned int position, std::index_sequence<I...>)
+	{
+		int expand[] = { 0, (std::get<I>(containers)->swap_entries(std::get<I>(containers)->index_of(e), position), 0)... };
+		(void)expand;
+	}
+
+	template <typename Func, size_t... I>
+	void call_packed(Func& func, unsigned int row, std::index_sequence<I...>)
+	{
+		func(std::get<0>(containers)->entities[row], std::get<I>(containers)->components[row]...);
+	}
+
+	template <typename Func, size_t... I>
+	void call_unpacked(Func& func, Entity e, std::index_sequence<I...>)
+	{
+		std::tuple<Components*...> found(std::get<I>(containers)->try_get(e)...);
+		if (all_of({ std::get<I>(found) != nullptr... }))
+			func(e, *std::get<I>(found)...);
+	}
+
+public:
+	PackedGroup(ComponentContainer<Components>*... components) : containers(components...)
+	{
+		static_assert(sizeof...(Components) > 1, "A group packs at least two component types");
+		attach(std::index_sequence_for<Components...>());
+	}
+	// the containers point back at the group
+	PackedGroup(const PackedGroup&) = delete;
+	PackedGroup& operator=(const PackedGroup&) = delete;
+
+	bool is_packed(Entity e) const
+	{
+		return std::get<0>(containers)->has(e) && std::get<0>(containers)->index_of(e) < count;
+	}
+
+	// Number of packed rows
+	size_t size() const { return count; }
+
+	bool is_enabled() const { return enabled; }
+
+	// Turning packing off leaves the rows where they are, turning it on packs them at the next pack()
+	void set_enabled(bool enable)
+	{
+		enabled = enable;
+		if (!enabled)
+			count = 0;
+	}
+
+	// Packs every entity that got the last of the components since the previous call
+	void pack()
+	{
+		if (!enabled)
+			return;
+		ComponentContainer<typename std::tuple_element<0, std::tuple<Components...>>::type>& first = *std::get<0>(containers);
+		for (unsigned int i = count; i < first.size(); i++)
+		{
+			// the row that was at 'count' moves to i, it was already checked
+			Entity e = first.entities[i];
+			if (complete(e, std::index_sequence_for<Components...>()))
+				move_row(e, count++, std::index_sequence_for<Components...>());
+		}
+	}
+
+	// Calls func(Entity, Components&...) for every entity that has all of the components,
+	// the packed rows in order and then the ones added since the last pack().
+	// Destroy through registry.commands while iterating, removing components right away would move the rows.
+	template <typename Func>
+	void each(Func func)
+	{
+		for (unsigned int row = 0; row < count; row++)
+			call_packed(func, row, std::index_sequence_for<Components...>());
+		const std::vector<Entity>& rest = std::get<0>(containers)->entities;
+		for (size_t i = count; i < rest.size(); i++)
+			call_unpacked(func, rest[i], std::index_sequence_for<Components...>());
+	}
+
+	void on_remove(Entity e) override
+	{
+		if (!is_packed(e))
+			return;
+		// the last packed row takes its place, e is right behind the packed rows then
+		move_row(e, --count, std::index_sequence_for<Components...>());
+	}
+
+	void on_clear() override
+	{
+		count = 0;
+	}
+};
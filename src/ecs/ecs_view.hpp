@@ -0,0 +1,152 @@
+#pragma once
+
+#include <tuple>
+#include <utility>
+#include <initializer_list>
+
+#include "ecs/ecs.hpp"
+
+// Lists component types an entity must not have, e.g. registry.view<Motion>(exclude<NoCollisionCheck>)
+template <typename... Excluded>
+struct Exclude {};
+
+template <typename... Excluded>
+constexpr Exclude<Excluded...> exclude{};
+
+template <typename Included, typename Excluded>
+class View;
+
+// A query over all entities that have every component in 'Components' and none in 'Excluded'.
+// Iteration is driven by the smallest of the included containers, the others are only probed.
+// Destroying (or removing components of) the current entity while iterating is safe.
+template <typename... Components, typename... Excluded>
+class View<std::tuple<Components...>, std::tuple<Excluded...>>
+{
+	std::tuple<ComponentContainer<Components>*...> included;
+	std::tuple<ComponentContainer<Excluded>*...> excluded;
+	// Entity list of the smallest included container
+	const std::vector<Entity>* driver;
+
+	static bool all_of(std::initializer_list<bool> values)
+	{
+		for (bool v : values)
+			if (!v)
+				return false;
+		return true;
+	}
+
+	template <size_t... I>
+	bool has_included(Entity e, std::index_sequence<I...>) const
+	{
+		return all_of({ std::get<I>(included)->has(e)... });
+	}
+
+	template <size_t... I>
+	bool has_excluded(Entity e, std::index_sequence<I...>) const
+	{
+		return !all_of({ !std::get<I>(excluded)->has(e)... });
+	}
+
+	template <size_t... I>
+	void pick_driver(std::index_sequence<I...>)
+	{
+		const std::vector<Entity>* lists[] = { &std::get<I>(included)->entities... };
+		driver = lists[0];
+		for (const std::vector<Entity>* list : lists)
+			if (list->size() < driver->size())
+				driver = list;
+	}
+
+	// Calls func with the entity and its components if the entity matches
+	template <typename Func, size_t... I>
+	void call(Func& func, Entity e, std::index_sequence<I...>)
+	{
+		// one lookup per container, the pointers are handed on as references
+		std::tuple<Components*...> found(std::get<I>(included)->try_get(e)...);
+		if (all_of({ std::get<I>(found) != nullptr... }) && !matches_excluded(e))
+			func(e, *std::get<I>(found)...);
+	}
+
+	bool matches_excluded(Entity e) const
+	{
+		return has_excluded(e, std::index_sequence_for<Excluded...>());
+	}
+
+	// Advance from 'index' to the next matching entity, moves past the entity last visited unless it was removed
+	size_t next(size_t index, Entity visited) const
+	{
+		if (index < driver->size() && (*driver)[index] == visited)
+			index++;
+		while (index < driver->size() && !contains((*driver)[index]))
+			index++;
+		return index;
+	}
+
+public:
+	View(ComponentContainer<Components>*... components, ComponentContainer<Excluded>*... exclusions)
+		: included(components...), excluded(exclusions...)
+	{
+		static_assert(sizeof...(Components) > 0, "A view needs at least one component type");
+		pick_driver(std::index_sequence_for<Components...>());
+	}
+
+	bool contains(Entity e) const
+	{
+		return has_included(e, std::index_sequence_for<Components...>()) && !matches_excluded(e);
+	}
+
+	class iterator
+	{
+		const View* view;
+		size_t index;
+		Entity current = Entity::null();
+	public:
+		iterator(const View* view, size_t index) : view(view), index(index)
+		{
+			if (index < view->driver->size() && !view->contains((*view->driver)[index]))
+				this->index = view->next(index, Entity::null());
+			if (this->index < view->driver->size())
+				current = (*view->driver)[this->index];
+		}
+		Entity operator*() const { return current; }
+		iterator& operator++()
+		{
+			index = view->next(index, current);
+			if (index < view->driver->size())
+				current = (*view->driver)[index];
+			return *this;
+		}
+		// The end position moves when entities are removed, so every iterator past the end compares equal
+		bool operator!=(const iterator& other) const
+		{
+			const bool at_end = index >= view->driver->size();
+			const bool other_at_end = other.index >= view->driver->size();
+			return at_end != other_at_end || (!at_end && index != other.index);
+		}
+	};
+
+	iterator begin() const { return iterator(this, 0); }
+	iterator end() const { return iterator(this, driver->size()); }
+
+	// Calls func(Entity, Components&...) for every matching entity
+	template <typename Func>
+	void each(Func func)
+	{
+		size_t index = 0;
+		while (index < driver->size())
+		{
+			Entity e = (*driver)[index];
+			call(func, e, std::index_sequence_for<Components...>());
+			// stay on this index if the entity was removed and another one was moved into its place
+			if (index < driver->size() && (*driver)[index] == e)
+				index++;
+		}
+	}
+};
+
+// View over explicitly given containers, for containers that share a component type (e.g. registry.guidedMissiles)
+template <typename... Components>
+View<std::tuple<Components...>, std::tuple<>> view_of(ComponentContainer<Components>&... containers)
+{
+	return View<std::tuple<Components...>, std::tuple<>>(&containers...);
+}
@@ -1,3 +1,11 @@
 #include "ecs_registry/ecs_registry.hpp"
+#include "profiler/profiler.hpp"
 
-ECSRegistry registry;
\ No newline at end of file
+ECSRegistry registry;
+
+void ECSRegistry::flush_commands()
+{
+	PROFILE_SCOPE("registry.flush_commands");
+	commands.flush(registry_list);
+	projectile_rows.pack();
+}
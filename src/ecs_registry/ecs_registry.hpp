@@ -2,6 +2,9 @@
 #include <vector>
 
 #include "ecs/ecs.hpp"
+#include "ecs/ecs_view.hpp"
+#include "ecs/ecs_commands.hpp"
+#include "ecs/ecs_group.hpp"
 #include "components/components.hpp"
 
 class ECSRegistry
@@ -46,6 +49,13 @@ public:
 	ComponentContainer<PowerupPopUp> powerupPopUps;
 	ComponentContainer<Immobile> immobiles;
 
+	// Deferred destroys and component changes, applied at the sync points in the main loop by flush_commands()
+	CommandBuffer commands;
+
+	// The projectile and motion of every projectile packed side by side, for the passes over all projectiles.
+	// Packing moves components, which is why it only happens in flush_commands() next to the destroys.
+	PackedGroup<Projectile, Motion> projectile_rows{ &projectiles, &motions };
+
 	// constructor that adds all containers for looping over them
 	// IMPORTANT: Don't forget to add any newly added containers!
 	ECSRegistry()
@@ -80,6 +90,10 @@ public:
 		registry_list.push_back(&guidedMissiles);
 		registry_list.push_back(&tutorialOnlys);
 		registry_list.push_back(&multiplierBoostPowerupTimers);
+		registry_list.push_back(&muzzleFlashTimers);
+		registry_list.push_back(&powerups);
+		registry_list.push_back(&powerupPopUps);
+		registry_list.push_back(&immobiles);
 	}
 
 	void clear_all_components() {
@@ -101,10 +115,61 @@ public:
 				printf("type %s\n", typeid(*reg).name());
 	}
 
+	// Applies the recorded commands, then packs the projectile rows completed since the last call
+	void flush_commands();
+
+	// The container holding components of type 'Component', see the specializations below
+	template <typename Component>
+	ComponentContainer<Component>& container();
+
+	// Query all entities that have every listed component, e.g. registry.view<Motion, Projectile>(exclude<NoCollisionCheck>)
+	template <typename... Components, typename... Excluded>
+	View<std::tuple<Components...>, std::tuple<Excluded...>> view(Exclude<Excluded...> = {}) {
+		return View<std::tuple<Components...>, std::tuple<Excluded...>>(&container<Components>()..., &container<Excluded>()...);
+	}
+
+	// Destroys the entity, its index is recycled and any remaining handles to it become stale
 	void remove_all_components_of(Entity e) {
 		for (ContainerInterface* reg : registry_list)
 			reg->remove(e);
+		Entity::release(e);
 	}
 };
 
+// Component type -> container used by registry.view<...>()
+// Note, guidedMissiles shares the Projectile type with projectiles, use view_of(registry.guidedMissiles, ...) for it
+template <> inline ComponentContainer<DeathTimer>& ECSRegistry::container<DeathTimer>() { return deathTimers; }
+template <> inline ComponentContainer<Obstacle>& ECSRegistry::container<Obstacle>() { return obstacles; }
+template <> inline ComponentContainer<Deadly>& ECSRegistry::container<Deadly>() { return deadlies; }
+template <> inline ComponentContainer<Motion>& ECSRegistry::container<Motion>() { return motions; }
+template <> inline ComponentContainer<Collision>& ECSRegistry::container<Collision>() { return collisions; }
+template <> inline ComponentContainer<Player>& ECSRegistry::container<Player>() { return players; }
+template <> inline ComponentContainer<Mesh*>& ECSRegistry::container<Mesh*>() { return meshPtrs; }
+template <> inline ComponentContainer<RenderRequest>& ECSRegistry::container<RenderRequest>() { return renderRequests; }
+template <> inline ComponentContainer<ScreenState>& ECSRegistry::container<ScreenState>() { return screenStates; }
+template <> inline ComponentContainer<Projectile>& ECSRegistry::container<Projectile>() { return projectiles; }
+template <> inline ComponentContainer<DebugComponent>& ECSRegistry::container<DebugComponent>() { return debugComponents; }
+template <> inline ComponentContainer<vec3>& ECSRegistry::container<vec3>() { return colors; }
+template <> inline ComponentContainer<Health>& ECSRegistry::container<Health>() { return healths; }
+template <> inline ComponentContainer<Shield>& ECSRegistry::container<Shield>() { return shields; }
+template <> inline ComponentContainer<Room>& ECSRegistry::container<Room>() { return rooms; }
+template <> inline ComponentContainer<Text>& ECSRegistry::container<Text>() { return texts; }
+template <> inline ComponentContainer<AI>& ECSRegistry::container<AI>() { return ais; }
+template <> inline ComponentContainer<RoomTransitionTimer>& ECSRegistry::container<RoomTransitionTimer>() { return roomTransitionTimers; }
+template <> inline ComponentContainer<Animation>& ECSRegistry::container<Animation>() { return animations; }
+template <> inline ComponentContainer<AnimationTimer>& ECSRegistry::container<AnimationTimer>() { return animationTimers; }
+template <> inline ComponentContainer<NoCollisionCheck>& ECSRegistry::container<NoCollisionCheck>() { return noCollisionChecks; }
+template <> inline ComponentContainer<OnFireTimer>& ECSRegistry::container<OnFireTimer>() { return onFireTimers; }
+template <> inline ComponentContainer<MuzzleFlashTimer>& ECSRegistry::container<MuzzleFlashTimer>() { return muzzleFlashTimers; }
+template <> inline ComponentContainer<DamagedTimer>& ECSRegistry::container<DamagedTimer>() { return damagedTimers; }
+template <> inline ComponentContainer<ShopPanel>& ECSRegistry::container<ShopPanel>() { return shopPanels; }
+template <> inline ComponentContainer<Level>& ECSRegistry::container<Level>() { return levels; }
+template <> inline ComponentContainer<Button>& ECSRegistry::container<Button>() { return buttons; }
+template <> inline ComponentContainer<MultiplierBoostPowerupTimer>& ECSRegistry::container<MultiplierBoostPowerupTimer>() { return multiplierBoostPowerupTimers; }
+template <> inline ComponentContainer<PowerupRandom>& ECSRegistry::container<PowerupRandom>() { return powerups; }
+template <> inline ComponentContainer<BossAI>& ECSRegistry::container<BossAI>() { return bosses; }
+template <> inline ComponentContainer<TutorialOnly>& ECSRegistry::container<TutorialOnly>() { return tutorialOnlys; }
+template <> inline ComponentContainer<PowerupPopUp>& ECSRegistry::container<PowerupPopUp>() { return powerupPopUps; }
+template <> inline ComponentContainer<Immobile>& ECSRegistry::container<Immobile>() { return immobiles; }
+
 extern ECSRegistry registry;
@@ -0,0 +1,281 @@
+// Headless simulation runner, steps the game logic as fast as the CPU allows without a window,
+// OpenGL or audio (see null_render_system.cpp, null_audio.cpp and null_platform.cpp).
+// The player is driven by scripted input or by a recording of the game (./void --record file),
+// so it can be used to benchmark and soak-test the simulation.
+// Build the void_headless target and run
+//   ./void_headless [--steps N] [--seed N] [--record file]   scripted input
+//   ./void_headless --replay file                            recorded input
+// --threads N runs the parallel parts of the AI step on N worker threads, 0 runs them serially. The result is the same.
+// --enemies N keeps N enemies of all types in the room to load the AI, the player stays in the room and fires
+// in circles. Recordings store the count, --replay spawns the same enemies again.
+// The seed defaults to 0, so two runs with the same arguments simulate exactly the same game.
+// Every step is profiled, --profile name also writes name.csv and the Chrome trace name.json.
+
+// stlib
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+// internal
+#include "physics_system/physics_system.hpp"
+#include "render_system/render_system.hpp"
+#include "world_system/world_system.hpp"
+#include "ai_system/ai_system.hpp"
+#include "ui_system/ui_system.hpp"
+#include "weapon_system/weapon_system.hpp"
+#include "powerup_system/powerup_system.hpp"
+#include "boss/boss.hpp"
+#include "random_service/random_service.hpp"
+#include "replay/input_log.hpp"
+#include "profiler/profiler.hpp"
+#include "job_system/job_system.hpp"
+#include "ai_system/ai_params.hpp"
+
+using Clock = std::chrono::high_resolution_clock;
+
+// One phase of the scripted input, the movement key is held for the whole phase
+struct ScriptPhase
+{
+	int move_key;
+	int steps;
+};
+
+const ScriptPhase script[] = {
+	{ GLFW_KEY_W, 120 },
+	{ GLFW_KEY_D, 120 },
+	{ GLFW_KEY_S, 120 },
+	{ GLFW_KEY_A, 120 },
+	{ GLFW_KEY_D, 60 },
+	{ GLFW_KEY_W, 60 },
+};
+const int script_length = sizeof(script) / sizeof(script[0]);
+
+// Plays the script in a loop: walk around, aim in a circle, keep firing, reload and switch weapons now and then.
+// A player that stands still stays in the first room instead of walking out of its open doors.
+class ScriptedInput
+{
+	WorldSystem& world;
+	bool walk;
+	int phase = 0;
+	int phase_step = 0;
+	int step = 0;
+
+public:
+	ScriptedInput(WorldSystem& world, bool walk) : world(world), walk(walk) {}
+
+	void start()
+	{
+		// leave the start menu
+		world.on_key(GLFW_KEY_ENTER, 0, GLFW_RELEASE, 0);
+		if (walk)
+			world.on_key(script[0].move_key, 0, GLFW_PRESS, 0);
+		world.on_mouse_click(GLFW_MOUSE_BUTTON_LEFT, GLFW_PRESS, 0);
+	}
+
+	void update()
+	{
+		if (walk && ++phase_step >= script[phase].steps) {
+			world.on_key(script[phase].move_key, 0, GLFW_RELEASE, 0);
+			phase = (phase + 1) % script_length;
+			phase_step = 0;
+			world.on_key(script[phase].move_key, 0, GLFW_PRESS, 0);
+		}
+
+		float aim_angle = step * 0.02f;
+		world.on_mouse_move({ window_width_px / 2 + 300.f * cos(aim_angle), window_height_px / 2 + 300.f * sin(aim_angle) });
+
+		if (step % 600 == 599) {
+			world.on_key(GLFW_KEY_R, 0, GLFW_PRESS, 0);
+			world.on_key(GLFW_KEY_R, 0, GLFW_RELEASE, 0);
+		}
+		if (step % 1800 == 1799) {
+			world.on_key(GLFW_KEY_E, 0, GLFW_PRESS, 0);
+			world.on_key(GLFW_KEY_E, 0, GLFW_RELEASE, 0);
+		}
+		// play again from the game over screen
+		if (registry.players.size() == 0) {
+			world.on_key(GLFW_KEY_ENTER, 0, GLFW_RELEASE, 0);
+		}
+		// the player may have died and the game restarted, keep the trigger held
+		if (step % 120 == 0) {
+			world.on_mouse_click(GLFW_MOUSE_BUTTON_LEFT, GLFW_PRESS, 0);
+		}
+		step++;
+	}
+};
+
+// Fills the free cells of the current room with enemies of every type, row by row from the top left
+static void spawn_enemies(RenderSystem& renderer, int count)
+{
+	Level& level = registry.levels.get(registry.levels.entities[0]);
+	Room& room = registry.rooms.get(level.rooms[level.current_room]);
+	const vec2 room_origin = { (window_width_px - game_window_size_px) / 2, (window_height_px - game_window_size_px) / 2 };
+
+	int spawned = 0;
+	for (int pass = 0; spawned < count; pass++) {
+		// stay off the walls, later passes put enemies in between the cells
+		for (int y = 2; y < room_grid_size - 2 && spawned < count; y++) {
+			for (int x = 2; x < room_grid_size - 2 && spawned < count; x++) {
+				if (room.is_obstacle({ x, y }))
+					continue;
+				vec2 cell = vec2(x, y) + vec2(0.5f + 0.25f * (pass % 3), 0.5f + 0.25f * (pass / 3 % 3));
+				createEnemy(&renderer, room_origin + cell * (float)game_window_block_size, 500.f, (AI::AIType)(spawned % ai_type_count), false);
+				// the room keeps track of its enemies like for generated ones, killing them all clears it
+				room.enemy_positions.insert(cell - vec2(0.5f));
+				room.enemy_count++;
+				spawned++;
+			}
+		}
+	}
+}
+
+// FNV-1a over the positions of everything that moves, equal for two runs that simulated the same game
+static uint64_t world_checksum()
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (const Motion& motion : registry.motions.components) {
+		const unsigned char* bytes = (const unsigned char*)&motion.position;
+		for (unsigned int i = 0; i < sizeof(motion.position); i++)
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+
+static void print_usage(const char* program)
+{
+	printf("Usage: %s [--steps N] [--seed N] [--record file] [--replay file] [--profile name]"
+		" [--enemies N] [--threads N]\n", program);
+}
+
+// Entry point
+int main(int argc, char* argv[])
+{
+	int steps = 120 * 60;
+	uint64_t seed = 0;
+	const char* record_path = nullptr;
+	const char* replay_path = nullptr;
+	const char* profile_name = nullptr;
+	int enemy_count = 0;
+	unsigned int worker_count = default_worker_count();
+	const std::string options[] = { "--steps", "--seed", "--record", "--replay", "--profile", "--enemies", "--threads" };
+	for (int i = 1; i < argc; i += 2) {
+		std::string option = argv[i];
+		if (std::find(std::begin(options), std::end(options), option) == std::end(options)) {
+			printf("Unknown option %s\n", option.c_str());
+			print_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+		if (i + 1 == argc) {
+			printf("Missing value for %s\n", option.c_str());
+			print_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+		if (option == "--steps")
+			steps = std::atoi(argv[i + 1]);
+		else if (option == "--seed")
+			seed = std::strtoull(argv[i + 1], nullptr, 10);
+		else if (option == "--record")
+			record_path = argv[i + 1];
+		else if (option == "--replay")
+			replay_path = argv[i + 1];
+		else if (option == "--profile")
+			profile_name = argv[i + 1];
+		else if (option == "--enemies")
+			enemy_count = std::atoi(argv[i + 1]);
+		else if (option == "--threads")
+			worker_count = (unsigned int)std::atoi(argv[i + 1]);
+	}
+
+	InputReplay replay;
+	if (replay_path) {
+		if (!replay.load(replay_path))
+			return EXIT_FAILURE;
+		seed = replay.get_seed();
+		steps = replay.length();
+		// the recorded session ran with its own enemy count, spawning others would diverge from it
+		if (enemy_count > 0 && enemy_count != (int)replay.get_enemies()) {
+			printf("%s was recorded with --enemies %u\n", replay_path, replay.get_enemies());
+			return EXIT_FAILURE;
+		}
+		enemy_count = (int)replay.get_enemies();
+	}
+	random_service.seed(seed);
+	profiler.start_capture();
+	jobs.start(worker_count);
+
+	// Global systems
+	WorldSystem world;
+	RenderSystem renderer;
+	PowerupSystem powerups;
+	UISystem ui;
+	WeaponSystem weapons;
+	PhysicsSystem physics;
+	AISystem ai(&renderer);
+	Boss boss(&renderer);
+
+	// initialize the main systems, there is no window
+	renderer.init(nullptr);
+	world.init(&renderer, &ui, &weapons, &powerups);
+
+	InputRecorder recorder(seed);
+	recorder.set_enemies((uint32_t)enemy_count);
+	if (record_path)
+		world.recorder = &recorder;
+
+	ScriptedInput input(world, enemy_count == 0);
+	if (!replay_path)
+		input.start();
+	else
+		world.replaying = true;
+
+	size_t peak_entities = 0;
+	auto start = Clock::now();
+	int step = 0;
+	for (; step < steps && !world.is_over(); step++) {
+		profiler.begin_frame();
+		if (replay_path)
+			replay.feed(world);
+		else
+			input.update();
+		// again whenever they are all dead or the game restarted
+		if (enemy_count > 0 && registry.ais.size() == 0 && registry.players.size() > 0)
+			spawn_enemies(renderer, enemy_count);
+
+		// same order as the fixed step loop in main.cpp
+		world.step(simulation_step_ms);
+		registry.flush_commands();
+
+		if (!world.is_paused) {
+			if (!world.invincible) {
+				ai.step(simulation_step_ms);
+			}
+			physics.step(simulation_step_ms);
+			world.handle_collisions(simulation_step_ms);
+			boss.step(simulation_step_ms);
+			boss.updateGuidedMissiles(simulation_step_ms);
+		}
+		recorder.next_tick();
+		profiler.end_frame();
+
+		peak_entities = std::max(peak_entities, registry.motions.size());
+	}
+	float elapsed_ms = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+
+	float simulated_s = step * simulation_step_ms / 1000.f;
+	std::cout << "Simulated " << step << " steps (" << simulated_s << " s of game time) in " << elapsed_ms << " ms" << std::endl;
+	std::cout << "  " << elapsed_ms * 1000.f / std::max(step, 1) << " us per step, "
+		<< simulated_s * 1000.f / std::max(elapsed_ms, 0.001f) << "x real time" << std::endl;
+	std::cout << "  " << registry.motions.size() << " entities with motion at the end, " << peak_entities << " at most, " << registry.ais.size() << " AIs left" << std::endl;
+	std::cout << "  seed " << seed << ", world checksum " << std::hex << world_checksum() << std::dec << std::endl;
+	profiler.print_summary();
+
+	if (profile_name) {
+		profiler.save_csv(std::string(profile_name) + ".csv");
+		profiler.save_chrome_trace(std::string(profile_name) + ".json");
+	}
+	if (record_path && recorder.save(record_path))
+		std::cout << "Input recorded to " << record_path << std::endl;
+
+	return EXIT_SUCCESS;
+}
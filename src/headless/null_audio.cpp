@@ -0,0 +1,34 @@
+// Null audio backend for the headless simulation, replaces audio_manager.cpp.
+// The sounds stay nullptr, so nothing in the game ever hands SDL_mixer a real chunk.
+
+// internal
+#include "audio_manager/audio_manager.hpp"
+
+// Sounds
+Mix_Chunk* gatling_gun_sound = nullptr;
+Mix_Chunk* sniper_sound = nullptr;
+Mix_Chunk* shotgun_sound = nullptr;
+Mix_Chunk* rocket_launcher_sound = nullptr;
+Mix_Chunk* flamethrower_sound = nullptr;
+Mix_Chunk* energy_halo_sound = nullptr;
+Mix_Chunk* reload_start_sound = nullptr;
+Mix_Chunk* reload_end_sound = nullptr;
+Mix_Chunk* no_ammo_sound = nullptr;
+Mix_Chunk* explosion_sound = nullptr;
+Mix_Chunk* cycle_weapon_sound = nullptr;
+Mix_Chunk* player_hit_sound = nullptr;
+Mix_Chunk* enemy_hit_sound = nullptr;
+Mix_Chunk* game_start_sound = nullptr;
+Mix_Chunk* game_over_sound = nullptr;
+
+// Music
+Mix_Music* start_menu_music = nullptr;
+Mix_Music* game_music = nullptr;
+Mix_Music* game_win_music = nullptr;
+Mix_Music* boss_music = nullptr;
+
+bool init_audio() { return true; }
+void play_sound(Mix_Chunk*) {}
+void play_music(Mix_Music*) {}
+void stop_music() {}
+void close_audio() {}
@@ -0,0 +1,52 @@
+// Null window and timer backend for the headless simulation.
+// Defines the few GLFW, SDL and gl3w symbols the game logic calls outside of the renderer,
+// so the headless target links without GLFW, SDL or OpenGL. There is no window: input comes
+// from the headless runner calling the WorldSystem input callbacks directly.
+
+// stlib
+#include <chrono>
+
+// internal
+#include "common/common.hpp"
+#include <SDL.h>
+
+namespace {
+	int window_should_close = 0;
+	void* window_user_pointer = nullptr;
+	const auto start_time = std::chrono::steady_clock::now();
+}
+
+// only ever called by gl_has_errors, which the null renderer does not use
+PFNGLGETERRORPROC gl3wGetError = nullptr;
+
+int glfwInit(void) { return GLFW_TRUE; }
+void glfwWindowHint(int, int) {}
+GLFWerrorfun glfwSetErrorCallback(GLFWerrorfun) { return nullptr; }
+GLFWmonitor* glfwGetPrimaryMonitor(void) { return nullptr; }
+GLFWwindow* glfwCreateWindow(int, int, const char*, GLFWmonitor*, GLFWwindow*) { return nullptr; }
+void glfwDestroyWindow(GLFWwindow*) {}
+
+int glfwWindowShouldClose(GLFWwindow*) { return window_should_close; }
+void glfwSetWindowShouldClose(GLFWwindow*, int value) { window_should_close = value; }
+void glfwSetWindowUserPointer(GLFWwindow*, void* pointer) { window_user_pointer = pointer; }
+void* glfwGetWindowUserPointer(GLFWwindow*) { return window_user_pointer; }
+void glfwGetWindowSize(GLFWwindow*, int* width, int* height)
+{
+	if (width)
+		*width = window_width_px;
+	if (height)
+		*height = window_height_px;
+}
+
+GLFWkeyfun glfwSetKeyCallback(GLFWwindow*, GLFWkeyfun) { return nullptr; }
+GLFWcursorposfun glfwSetCursorPosCallback(GLFWwindow*, GLFWcursorposfun) { return nullptr; }
+GLFWscrollfun glfwSetScrollCallback(GLFWwindow*, GLFWscrollfun) { return nullptr; }
+GLFWmousebuttonfun glfwSetMouseButtonCallback(GLFWwindow*, GLFWmousebuttonfun) { return nullptr; }
+void glfwSetInputMode(GLFWwindow*, int, int) {}
+GLFWcursor* glfwCreateStandardCursor(int) { return nullptr; }
+void glfwSetCursor(GLFWwindow*, GLFWcursor*) {}
+
+Uint32 SDL_GetTicks(void)
+{
+	return (Uint32)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+}
@@ -0,0 +1,57 @@
+// Null renderer for the headless simulation, replaces render_system.cpp and render_system_init.cpp.
+// Only the collision meshes are loaded (physics reads them through getMesh), nothing touches OpenGL.
+
+// internal
+#include "render_system/render_system.hpp"
+#include "ecs_registry/ecs_registry.hpp"
+
+bool RenderSystem::init(GLFWwindow* window_arg)
+{
+	this->window = window_arg;
+	initScreenTexture();
+	initializeGlMeshes();
+	return true;
+}
+
+void RenderSystem::initializeGlMeshes()
+{
+	for (uint i = 0; i < mesh_paths.size(); i++)
+	{
+		GEOMETRY_BUFFER_ID geom_index = mesh_paths[i].first;
+		Mesh::loadFromOBJFile(mesh_paths[i].second,
+			meshes[(int)geom_index].vertices,
+			meshes[(int)geom_index].vertex_indices,
+			meshes[(int)geom_index].original_size);
+	}
+}
+
+void RenderSystem::initializeGlTextures() {}
+void RenderSystem::initializeGlSheets() {}
+void RenderSystem::initializeGlEffects() {}
+void RenderSystem::initializeGlGeometryBuffers() {}
+// The world darkens the screen through the screen state, it has to exist without a screen as well
+bool RenderSystem::initScreenTexture()
+{
+	registry.screenStates.emplace(screen_state_entity);
+	return true;
+}
+bool RenderSystem::initializeFonts() { return true; }
+
+bool RenderSystem::loadEffectFromFile(const std::string&, const std::string&, GLuint&) { return true; }
+bool RenderSystem::loadFontFromFile(const std::string&, unsigned int) { return true; }
+
+RenderSystem::~RenderSystem() {}
+
+void RenderSystem::draw(float interpolation)
+{
+	this->interpolation = interpolation;
+}
+
+void RenderSystem::drawText(const mat3&, bool) {}
+void RenderSystem::drawTexturedMesh(Entity, const mat3&) {}
+void RenderSystem::drawToScreen(const mat3&) {}
+
+mat3 RenderSystem::createProjectionMatrix()
+{
+	return mat3(1.f);
+}
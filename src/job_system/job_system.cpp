@@ -0,0 +1,121 @@
+// internal
+#include "job_system/job_system.hpp"
+
+// stlib
+#include <algorithm>
+
+JobSystem jobs;
+
+thread_local unsigned int JobSystem::current_thread = 0;
+
+unsigned int default_worker_count()
+{
+	// more workers than this only add wake up and stealing cost for the few hundred AIs of a room
+	const unsigned int max_workers = 7;
+	unsigned int cores = std::thread::hardware_concurrency();
+	return cores > 1 ? std::min(cores - 1, max_workers) : 0;
+}
+
+void JobSystem::start(unsigned int worker_count)
+{
+	stop();
+	stopping = false;
+	queues.reset(new Queue[worker_count + 1]);
+	for (unsigned int i = 1; i <= worker_count; i++)
+		workers.emplace_back(&JobSystem::worker_main, this, i);
+}
+
+void JobSystem::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(wake_mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread& worker : workers)
+		worker.join();
+	workers.clear();
+}
+
+void JobSystem::parallel_for(unsigned int count, unsigned int grain, const std::function<void(unsigned int, unsigned int)>& job_function)
+{
+	grain = std::max(grain, 1u);
+	if (workers.empty() || count <= grain) {
+		if (count > 0)
+			job_function(0, count);
+		return;
+	}
+
+	job = &job_function;
+	unsigned int batches = (count + grain - 1) / grain;
+	pending.store(batches);
+	// deal the batches out in turn, so every thread starts on its own share
+	for (unsigned int b = 0; b < batches; b++) {
+		Queue& queue = queues[b % thread_count()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.ranges.push_back({ b * grain, std::min((b + 1) * grain, count) });
+	}
+	{
+		std::lock_guard<std::mutex> lock(wake_mutex);
+		generation++;
+	}
+	wake.notify_all();
+
+	// help until the last batch is done, the workers may still be running theirs after our queue is empty
+	while (pending.load() > 0) {
+		work(0);
+		std::this_thread::yield();
+	}
+	job = nullptr;
+}
+
+bool JobSystem::pop(unsigned int thread, Range& range)
+{
+	Queue& queue = queues[thread];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.ranges.empty())
+		return false;
+	range = queue.ranges.back();
+	queue.ranges.pop_back();
+	return true;
+}
+
+bool JobSystem::steal(unsigned int thread, Range& range)
+{
+	// take the oldest batch of another thread, the owner works from the other end
+	for (unsigned int k = 1; k < thread_count(); k++) {
+		Queue& queue = queues[(thread + k) % thread_count()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.ranges.empty())
+			continue;
+		range = queue.ranges.front();
+		queue.ranges.pop_front();
+		return true;
+	}
+	return false;
+}
+
+void JobSystem::work(unsigned int thread)
+{
+	Range range;
+	while (pop(thread, range) || steal(thread, range)) {
+		(*job)(range.begin, range.end);
+		pending.fetch_sub(1);
+	}
+}
+
+void JobSystem::worker_main(unsigned int thread)
+{
+	current_thread = thread;
+	unsigned int seen = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(wake_mutex);
+			wake.wait(lock, [&] { return stopping || generation != seen; });
+			if (stopping)
+				return;
+			seen = generation;
+		}
+		work(thread);
+	}
+}
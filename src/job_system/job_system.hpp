@@ -0,0 +1,72 @@
+#pragma once
+
+// stlib
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small work stealing job system for the data parallel parts of a step.
+// parallel_for() splits a range into batches that are spread over one queue per thread. Every thread,
+// the calling one included, works off its own queue first and then steals from the others, so uneven
+// batches (an AI that shoots next to one that only turns) still finish together.
+// The jobs may only read shared state and write what belongs to their own indices, anything else
+// (creating entities, the profiler, random streams) has to be collected per thread and done afterwards.
+class JobSystem
+{
+public:
+	~JobSystem() { stop(); }
+
+	// Starts the worker threads, with 0 workers everything runs on the calling thread
+	void start(unsigned int worker_count);
+	void stop();
+
+	// The workers plus the thread that calls parallel_for()
+	unsigned int thread_count() const { return (unsigned int)workers.size() + 1; }
+
+	// Index of the thread that runs the current job, 0 on the calling thread and 1..workers on the workers
+	static unsigned int thread_index() { return current_thread; }
+
+	// Calls job(begin, end) for batches of at most 'grain' indices covering [0, count) and returns when all are done.
+	// Ranges that fit in one batch run right here, without waking the workers. Not reentrant.
+	void parallel_for(unsigned int count, unsigned int grain, const std::function<void(unsigned int, unsigned int)>& job);
+
+private:
+	struct Range
+	{
+		unsigned int begin;
+		unsigned int end;
+	};
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Range> ranges;
+	};
+
+	std::vector<std::thread> workers;
+	std::unique_ptr<Queue[]> queues; // one per thread, 0 is the calling thread's
+
+	const std::function<void(unsigned int, unsigned int)>* job = nullptr;
+	std::atomic<unsigned int> pending{ 0 }; // batches not finished yet
+
+	std::mutex wake_mutex;
+	std::condition_variable wake;
+	unsigned int generation = 0; // bumped for every parallel_for, wakes the workers
+	bool stopping = false;
+
+	static thread_local unsigned int current_thread;
+
+	bool pop(unsigned int thread, Range& range);
+	bool steal(unsigned int thread, Range& range);
+	void work(unsigned int thread);
+	void worker_main(unsigned int thread);
+};
+
+// Workers for the hardware, one core is left to the calling thread
+unsigned int default_worker_count();
+
+extern JobSystem jobs;
@@ -3,7 +3,9 @@
 #include <gl3w.h>
 
 // stlib
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 
 // internal
 #include "physics_system/physics_system.hpp"
@@ -13,13 +15,64 @@
 #include "ui_system/ui_system.hpp"
 #include "weapon_system/weapon_system.hpp"
 #include "powerup_system/powerup_system.hpp"
+#include "random_service/random_service.hpp"
+#include "replay/input_log.hpp"
+#include "profiler/profiler.hpp"
+#include "job_system/job_system.hpp"
 #include <boss/boss.hpp>
 
 using Clock = std::chrono::high_resolution_clock;
 
+static void print_usage(const char* program)
+{
+	printf("Usage: %s [--seed N] [--record file] [--replay file] [--profile name]\n", program);
+}
+
 // Entry point
-int main()
+//   ./void [--seed N] [--record file]   play, optionally with a fixed session seed and recording the input
+//   ./void --replay file                replay a recording, one simulation step per frame
+// --profile name writes the time of every profiled section per frame to name.csv and a Chrome trace to name.json
+int main(int argc, char* argv[])
 {
+	uint64_t seed = random_session_seed();
+	const char* record_path = nullptr;
+	const char* replay_path = nullptr;
+	const char* profile_name = nullptr;
+	const std::string options[] = { "--seed", "--record", "--replay", "--profile" };
+	for (int i = 1; i < argc; i += 2) {
+		std::string option = argv[i];
+		if (std::find(std::begin(options), std::end(options), option) == std::end(options)) {
+			printf("Unknown option %s\n", option.c_str());
+			print_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+		if (i + 1 == argc) {
+			printf("Missing value for %s\n", option.c_str());
+			print_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+		if (option == "--seed")
+			seed = std::strtoull(argv[i + 1], nullptr, 10);
+		else if (option == "--record")
+			record_path = argv[i + 1];
+		else if (option == "--replay")
+			replay_path = argv[i + 1];
+		else if (option == "--profile")
+			profile_name = argv[i + 1];
+	}
+
+	InputReplay replay;
+	if (replay_path) {
+		if (!replay.load(replay_path))
+			return EXIT_FAILURE;
+		seed = replay.get_seed();
+	}
+	random_service.seed(seed);
+	printf("Session seed: %llu\n", (unsigned long long)seed);
+	if (profile_name)
+		profiler.start_capture();
+	jobs.start(default_worker_count());
+
 	// Global systems
 	WorldSystem world;
 	RenderSystem renderer;
@@ -45,32 +98,94 @@ int main()
 
 	renderer.initializeFonts();
 
-	// variable timestep loop
-	auto t = Clock::now();
-	while (!world.is_over()) {
-		// Processes system messages, if this wasn't present the window would become unresponsive
-		glfwPollEvents();
-
-		// Calculating elapsed times in milliseconds from the previous iteration
-		auto now = Clock::now();
-		float elapsed_ms =
-			(float)(std::chrono::duration_cast<std::chrono::microseconds>(now - t)).count() / 1000;
-		t = now;
-
-		world.step(elapsed_ms);
+	auto simulation_step = [&]() {
+		world.step(simulation_step_ms);
+		// sync point, apply the destroys recorded during the step (e.g. expired projectiles and animations)
+		registry.flush_commands();
 
 		if (!world.is_paused) {
 			if (!world.invincible) {
-				ai.step(elapsed_ms);
+				ai.step(simulation_step_ms);
 			}
-			physics.step(elapsed_ms);
-			world.handle_collisions(elapsed_ms);
-			boss.step(elapsed_ms);
-			boss.updateGuidedMissiles(elapsed_ms);
+			physics.step(simulation_step_ms);
+			world.handle_collisions(simulation_step_ms);
+			boss.step(simulation_step_ms);
+			boss.updateGuidedMissiles(simulation_step_ms);
+		}
+	};
+
+	InputRecorder recorder(seed);
+	if (record_path)
+		world.recorder = &recorder;
+
+	if (replay_path) {
+		world.replaying = true;
+		// the recording is the only input, the window still closes but ignores keys and the mouse
+		glfwSetKeyCallback(window, nullptr);
+		glfwSetCursorPosCallback(window, nullptr);
+		glfwSetScrollCallback(window, nullptr);
+		glfwSetMouseButtonCallback(window, nullptr);
+
+		// exactly one step per frame, so every run of the replay renders the same frames
+		while (!world.is_over() && !replay.finished()) {
+			glfwPollEvents();
+
+			profiler.begin_frame();
+			replay.feed(world);
+			simulation_step();
+			renderer.draw();
+			profiler.end_frame();
+			ui.fpsCalculate();
 		}
+	}
+	else {
+		// fixed timestep loop, the simulation always advances in steps of simulation_step_ms
+		// and rendering interpolates between the last two steps
+		// at most this many steps per frame, a long frame keeps at most one step of its leftover time
+		// so that a slow frame does not cause even more simulation work in the next one
+		const int max_simulation_steps = 8;
+		float accumulator_ms = 0.f;
+
+		auto t = Clock::now();
+		while (!world.is_over()) {
+			// Processes system messages, if this wasn't present the window would become unresponsive
+			glfwPollEvents();
+			profiler.begin_frame();
+
+			// Calculating elapsed times in milliseconds from the previous iteration
+			auto now = Clock::now();
+			float elapsed_ms =
+				(float)(std::chrono::duration_cast<std::chrono::microseconds>(now - t)).count() / 1000;
+			t = now;
+
+			accumulator_ms += elapsed_ms;
+			int steps = 0;
+			while (accumulator_ms >= simulation_step_ms && steps < max_simulation_steps) {
+				simulation_step();
+				// input polled from here on belongs to the next step
+				recorder.next_tick();
 
-		renderer.draw();
+				accumulator_ms -= simulation_step_ms;
+				steps++;
+			}
+			if (steps == max_simulation_steps) {
+				accumulator_ms = std::min(accumulator_ms, simulation_step_ms);
+			}
+
+			// how far the frame is between the last two simulation steps, nothing moves while paused
+			renderer.draw(world.is_paused ? 1.f : accumulator_ms / simulation_step_ms);
+			profiler.end_frame();
+			ui.fpsCalculate();
+
+		}
+	}
 
+	if (record_path && recorder.save(record_path))
+		printf("Input recorded to %s\n", record_path);
+	if (profile_name) {
+		profiler.print_summary();
+		profiler.save_csv(std::string(profile_name) + ".csv");
+		profiler.save_chrome_trace(std::string(profile_name) + ".json");
 	}
 
 	return EXIT_SUCCESS;
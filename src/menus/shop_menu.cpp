@@ -429,6 +429,7 @@ void ShopMenu::render_ammo_page() {
 	// Create a scroll section for inc/dec
 	quantity_btn_container_e = Entity();
 	Motion& q_motion = registry.motions.emplace(quantity_btn_container_e);
+	set_collision_layer(q_motion, COLLISION_LAYER::UI);
 	
 	q_motion.position = { 
 		display_section_x + 96.f + 0.5f * game_window_block_size, 
@@ -653,6 +654,7 @@ void ShopMenu::render_misc_page() {
 	// Create the quantity scroll area
 	quantity_btn_container_e = Entity();
 	Motion& q_motion = registry.motions.emplace(quantity_btn_container_e);
+	set_collision_layer(q_motion, COLLISION_LAYER::UI);
 	q_motion.position = {
 		top_left_pos.x + 256.f + 1.f * game_window_block_size, 
 		window_height_px - 125.f + 0.25f * game_window_block_size
@@ -0,0 +1,193 @@
+// internal
+#include "physics_system/narrowphase.hpp"
+
+const int gjk_max_iterations = 32;
+// EPA works on a fixed polytope so it does not allocate, it stops early when that is full
+const int epa_max_vertices = 32;
+const float epa_tolerance = 0.01f;
+
+static vec2 furthest_point(const ConvexShape& shape, vec2 direction)
+{
+	vec2 best = shape.points[0];
+	float best_dot = dot(best, direction);
+	for (unsigned int i = 1; i < shape.count; i++) {
+		float d = dot(shape.points[i], direction);
+		if (d > best_dot) {
+			best_dot = d;
+			best = shape.points[i];
+		}
+	}
+	return best;
+}
+
+// Support point of the Minkowski difference a - b
+static vec2 support(const ConvexShape& a, const ConvexShape& b, vec2 direction)
+{
+	return furthest_point(a, direction) - furthest_point(b, -direction);
+}
+
+static vec2 centroid(const ConvexShape& shape)
+{
+	vec2 sum = { 0, 0 };
+	for (unsigned int i = 0; i < shape.count; i++)
+		sum += shape.points[i];
+	return sum / (float)shape.count;
+}
+
+// Perpendicular of v on the side of 'towards'
+static vec2 perpendicular(vec2 v, vec2 towards)
+{
+	vec2 p = { -v.y, v.x };
+	return dot(p, towards) < 0 ? -p : p;
+}
+
+static void project(const ConvexShape& shape, vec2 axis, float& min_dot, float& max_dot)
+{
+	min_dot = INFINITY;
+	max_dot = -INFINITY;
+	for (unsigned int i = 0; i < shape.count; i++) {
+		float d = dot(shape.points[i], axis);
+		min_dot = min(min_dot, d);
+		max_dot = max(max_dot, d);
+	}
+}
+
+// Tests the edge normals of 'edges' as separating axes, keeps the axis of least overlap
+static bool sat_axes(const ConvexShape& edges, const ConvexShape& a, const ConvexShape& b, Contact& contact)
+{
+	for (unsigned int i = 0; i < edges.count; i++) {
+		vec2 edge = edges.points[(i + 1) % edges.count] - edges.points[i];
+		float length = glm::length(edge);
+		if (length < 1e-6f)
+			continue;
+		vec2 axis = vec2(-edge.y, edge.x) / length;
+
+		float min_a, max_a, min_b, max_b;
+		project(a, axis, min_a, max_a);
+		project(b, axis, min_b, max_b);
+
+		float overlap = min(max_a, max_b) - max(min_a, min_b);
+		// We can draw a line between the two shapes, no collision
+		if (overlap <= 0.f)
+			return false;
+		if (overlap < contact.depth) {
+			contact.depth = overlap;
+			contact.normal = axis;
+		}
+	}
+	return true;
+}
+
+bool sat_collision(const ConvexShape& a, const ConvexShape& b, Contact& contact)
+{
+	contact.depth = INFINITY;
+	if (!sat_axes(a, a, b, contact) || !sat_axes(b, a, b, contact))
+		return false;
+
+	// the normal has to push a away from b
+	if (dot(centroid(a) - centroid(b), contact.normal) < 0.f)
+		contact.normal = -contact.normal;
+	return true;
+}
+
+// Expanding polytope algorithm, starts from the GJK triangle that contains the origin
+static bool epa(const ConvexShape& a, const ConvexShape& b, const vec2 simplex[3], Contact& contact)
+{
+	vec2 polytope[epa_max_vertices] = { simplex[0], simplex[1], simplex[2] };
+	int count = 3;
+
+	// keep the polytope counter-clockwise so (edge.y, -edge.x) points outwards
+	vec2 ab = polytope[1] - polytope[0];
+	vec2 ac = polytope[2] - polytope[0];
+	if (ab.x * ac.y - ab.y * ac.x < 0.f)
+		std::swap(polytope[1], polytope[2]);
+
+	while (true) {
+		// edge of the polytope closest to the origin
+		int closest = -1;
+		float closest_distance = INFINITY;
+		vec2 closest_normal = { 0, 0 };
+		for (int i = 0; i < count; i++) {
+			vec2 edge = polytope[(i + 1) % count] - polytope[i];
+			float length = glm::length(edge);
+			if (length < 1e-6f)
+				continue;
+			vec2 normal = vec2(edge.y, -edge.x) / length;
+			float distance = dot(normal, polytope[i]);
+			if (distance < closest_distance) {
+				closest_distance = distance;
+				closest_normal = normal;
+				closest = i;
+			}
+		}
+		if (closest < 0)
+			return false;
+
+		vec2 point = support(a, b, closest_normal);
+		if (dot(point, closest_normal) - closest_distance < epa_tolerance || count == epa_max_vertices) {
+			// the penetration of a into b is along the normal, a moves out the opposite way
+			contact.normal = -closest_normal;
+			contact.depth = max(closest_distance, 0.f);
+			return true;
+		}
+
+		// insert the new support point between the vertices of the closest edge
+		for (int i = count; i > closest + 1; i--)
+			polytope[i] = polytope[i - 1];
+		polytope[closest + 1] = point;
+		count++;
+	}
+}
+
+bool gjk_collision(const ConvexShape& a, const ConvexShape& b, Contact& contact)
+{
+	vec2 simplex[3];
+	int count = 0;
+
+	vec2 direction = centroid(a) - centroid(b);
+	if (dot(direction, direction) < 1e-12f)
+		direction = { 1.f, 0.f };
+	simplex[count++] = support(a, b, direction);
+	direction = -simplex[0];
+
+	for (int iteration = 0; iteration < gjk_max_iterations; iteration++) {
+		// the origin lies on the simplex, the shapes only touch
+		if (dot(direction, direction) < 1e-12f)
+			return false;
+
+		vec2 point = support(a, b, direction);
+		// the new point does not pass the origin, so the Minkowski difference does not contain it
+		if (dot(point, direction) <= 0.f)
+			return false;
+		simplex[count++] = point;
+
+		if (count == 2) {
+			vec2 ab = simplex[0] - simplex[1];
+			direction = perpendicular(ab, -simplex[1]);
+			continue;
+		}
+
+		// triangle, simplex[2] is the newest point
+		vec2 newest = simplex[2];
+		vec2 ab = simplex[1] - newest;
+		vec2 ac = simplex[0] - newest;
+		vec2 ab_normal = -perpendicular(ab, ac);
+		vec2 ac_normal = -perpendicular(ac, ab);
+		if (dot(ab_normal, -newest) > 0.f) {
+			// origin outside of edge ab, drop the oldest point
+			simplex[0] = simplex[1];
+			simplex[1] = newest;
+			count = 2;
+			direction = ab_normal;
+		}
+		else if (dot(ac_normal, -newest) > 0.f) {
+			simplex[1] = newest;
+			count = 2;
+			direction = ac_normal;
+		}
+		else {
+			return epa(a, b, simplex, contact);
+		}
+	}
+	return false;
+}
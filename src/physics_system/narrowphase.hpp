@@ -0,0 +1,28 @@
+#pragma once
+
+#include "common/common.hpp"
+
+// Convex narrowphase: SAT for polygons with known winding (boxes) and GJK/EPA for any convex
+// point set (the game space vertices of the *_ch.obj hull meshes, in whatever order the mesh has them).
+// Both report the minimum translation vector, full containment included.
+
+// Convex shape given by its vertices in game space, the array is not copied
+struct ConvexShape
+{
+	const vec2* points;
+	unsigned int count;
+};
+
+// Result of a narrowphase test.
+// Moving shape a by normal * depth separates it from shape b.
+struct Contact
+{
+	vec2 normal = { 0, 0 };
+	float depth = 0.f;
+};
+
+// Separating axis test, the points of both shapes must be ordered around the polygon
+bool sat_collision(const ConvexShape& a, const ConvexShape& b, Contact& contact);
+
+// GJK intersection test, followed by EPA for the penetration of intersecting shapes
+bool gjk_collision(const ConvexShape& a, const ConvexShape& b, Contact& contact);
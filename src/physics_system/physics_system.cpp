@@ -1,5 +1,7 @@
 // internal
 #include "physics_system/physics_system.hpp"
+#include "physics_system/narrowphase.hpp"
+#include "profiler/profiler.hpp"
 #include "world_init/world_init.hpp"
 
 // TODO: Improve bounding box collision detection into a more accurate 
@@ -15,296 +17,34 @@ vec2 get_bounding_box(const Motion &motion)
 }
 
 
-// Line-to-Line collision detection, source: https://www.jeffreythompson.org/collision-detection/line-line.php
-bool collide_line_line(vec3 l1_start, vec3 l1_end, vec3 l2_start, vec3 l2_end) {
-	float uA = (
-		(l2_end.x - l2_start.x) * (l1_start.y - l2_start.y) - (l2_end.y - l2_start.y) * (l1_start.x - l2_start.x)) / 
-		((l2_end.y - l2_start.y) * (l1_end.x - l1_start.x) - (l2_end.x - l2_start.x) * (l1_end.y - l1_start.y));
-	float uB = (
-		(l1_end.x - l1_start.x) * (l1_start.y - l2_start.y) - (l1_end.y - l1_start.y) * (l1_start.x - l2_start.x)) / 
-		((l2_end.y - l2_start.y) * (l1_end.x - l1_start.x) - (l2_end.x - l2_start.x) * (l1_end.y - l1_start.y));
-	return uA >= 0 && uA <= 1 && uB >= 0 && uB <= 1;
-}
-
-
-// Source: https://www.jeffreythompson.org/collision-detection/poly-poly.php
-bool collide_triangle_line(vec3 triangle[], vec3 line[]) {
-	// Detect whether a triangle collides with a line
-	for (int i = 0; i < 3; i++) {
-		vec3& p1 = triangle[i];
-		vec3& p2 = triangle[(i+1) % 3];
-
-		if (collide_line_line(p1, p2, line[0], line[1])) {
-			return true;
-		}
-	}
-
-	return false;
-}
-
-bool collide_triangle_triangle(vec3 triangle_1[], vec3 triangle_2[]) {
-	for (int i = 0; i < 3; i++) {
-		vec3 p1 = triangle_1[i];
-		vec3 p2 = triangle_1[(i+1) % 3];
-
-		vec3 line[] = { p1, p2 };
-		if (collide_triangle_line(triangle_2, line)) {
-			return true;
-		}
-	}
-	
-	return false;
-}
-
-/**
-* Pre-condition: 
-* - e1 have a Mesh component
-* - both e1 and e2 have Motion components
-*/
-bool mesh_to_box_collision_check(Entity e1, Entity e2) {
-	Mesh& e1_mesh = *registry.meshPtrs.get(e1);
-
-	Motion& e1_motion = registry.motions.get(e1);
-	Motion& e2_motion = registry.motions.get(e2);
-
-	Transform t1, t2;
-	//t1.translate(e1_motion.position);
-	t1.rotate(e1_motion.look_angle);
-	t1.scale(e1_motion.scale);
-
-	// Initialize box mesh
-	vec3 e2_vertices[] = {
-		{e2_motion.position.x - e2_motion.scale.x / 2, e2_motion.position.y - e2_motion.scale.y / 2, 0.f }, // top-left
-		{e2_motion.position.x + e2_motion.scale.x / 2, e2_motion.position.y - e2_motion.scale.y / 2, 0.f }, // top-right
-		{e2_motion.position.x + e2_motion.scale.x / 2, e2_motion.position.y + e2_motion.scale.y / 2, 0.f }, // bottom-right
-		{e2_motion.position.x - e2_motion.scale.x / 2, e2_motion.position.y + e2_motion.scale.y / 2, 0.f }, // bottom-left
-	};
-
-	int e2_indices[] = {0, 1, 2, 2, 0, 3};
-	
-	// Transform mesh coordinates into game space
-	std::vector<vec3> transformed_vertices;
-	for (int i = 0; i < e1_mesh.vertices.size(); i++) {
-		transformed_vertices.push_back(t1.mat * e1_mesh.vertices[i].position + vec3({ e1_motion.position.x, e1_motion.position.y, 0.f }));
-	}
-
-	for (int i = 0; i < e1_mesh.vertex_indices.size() / 3; i++) {
-		vec3 e1_tri[] = {
-			transformed_vertices[e1_mesh.vertex_indices[i * 3]],
-			transformed_vertices[e1_mesh.vertex_indices[(i * 3 + 1) % transformed_vertices.size()]],
-			transformed_vertices[e1_mesh.vertex_indices[(i * 3 + 2) % transformed_vertices.size()]]
-		};
-
-		for (int j = 0; j < 2; j++) {
-			vec3 e2_tri[] = {
-				e2_vertices[e2_indices[j * 3]],
-				e2_vertices[e2_indices[j * 3 + 1]],
-				e2_vertices[e2_indices[j * 3 + 2]],
-			};
-
-			if (collide_triangle_triangle(e1_tri, e2_tri)) {
-				return true;
-			}
-		}
-	}
-
-	return false;
-}
-
-/**
-* Pre-condition: 
-* - both e1 and e2 have Mesh components
-* - both e1 and e2 have Motion components 
-*/
-bool mesh_to_mesh_collision_check(Entity e1, Entity e2) {
-	Mesh& e1_mesh = *registry.meshPtrs.get(e1);
-	Mesh& e2_mesh = *registry.meshPtrs.get(e2);
-	
-	Motion& e1_motion = registry.motions.get(e1);
-	Motion& e2_motion = registry.motions.get(e2);
-
-	Transform t1, t2;
-	t1.rotate(e1_motion.look_angle);
-	t1.scale(e1_motion.scale);
-
-	t2.rotate(e2_motion.look_angle);
-	t2.scale(e2_motion.scale);
-	
-	// Transform the vertices of the mesh of entity_1 onto the game space
-	std::vector<vec3> e1_trans_vertices;
-	for (int i = 0; i < e1_mesh.vertices.size(); i++) 
-	{
-		e1_trans_vertices.push_back(t1.mat * e1_mesh.vertices[i].position + vec3({e1_motion.position.x, e1_motion.position.y, 0.f}));
-	}
-
-	// Transform the vertices of the mesh of entity_2 onto the game space
-	std::vector<vec3> e2_trans_vertices;
-	for (int i = 0; i < e2_mesh.vertices.size(); i++) 
-	{
-		e2_trans_vertices.push_back(t1.mat * e2_mesh.vertices[i].position + vec3({ e2_motion.position.x, e2_motion.position.y, 0.f }));
-	}
+// Re-transforms the mesh of the entity into game space, unless the hull is still up to date
+void update_hull(CollisionHull& hull, const Mesh& mesh, const Motion& motion)
+{
+	if (hull.mesh == &mesh && hull.position == motion.position && hull.angle == motion.look_angle && hull.scale == motion.scale)
+		return;
 
-	for (int i = 0; i < e1_mesh.vertex_indices.size() / 3; i++) 
-	{
-		vec3 e1_tri[] = {
-			e1_trans_vertices[e1_mesh.vertex_indices[i * 3]],
-			e1_trans_vertices[e1_mesh.vertex_indices[(i * 3 + 1) % e1_trans_vertices.size()]],
-			e1_trans_vertices[e1_mesh.vertex_indices[(i * 3 + 2) % e1_trans_vertices.size()]]
-		};
-
-		for (int j = 0; j < e2_mesh.vertex_indices.size() / 3; j++ ) {
-
-			vec3 e2_tri[] = {
-				e2_trans_vertices[e2_mesh.vertex_indices[j * 3]],
-				e2_trans_vertices[e2_mesh.vertex_indices[(j * 3 + 1) % e2_trans_vertices.size()]],
-				e2_trans_vertices[e2_mesh.vertex_indices[(j * 3 + 2) % e2_trans_vertices.size()]]
-			};
-
-			if (collide_triangle_triangle(e1_tri, e2_tri)) {
-				return true;
-			}
-		}
+	hull.mesh = &mesh;
+	hull.position = motion.position;
+	hull.angle = motion.look_angle;
+	hull.scale = motion.scale;
+
+	Transform t;
+	t.rotate(motion.look_angle);
+	t.scale(motion.scale);
+	vec3 offset = { motion.position.x, motion.position.y, 0.f };
+
+	// resize keeps the capacity, so this only allocates the first time or when the mesh grows
+	hull.vertices.resize(mesh.vertices.size());
+	hull.min = { INFINITY, INFINITY };
+	hull.max = { -INFINITY, -INFINITY };
+	for (size_t i = 0; i < mesh.vertices.size(); i++) {
+		vec2 vertex = vec2(t.mat * mesh.vertices[i].position + offset);
+		hull.vertices[i] = vertex;
+		hull.min = min(hull.min, vertex);
+		hull.max = max(hull.max, vertex);
 	}
-
-	return false;
 }
 
-// Material for the SAT collision detection is sourced from the following blog post
-// https://code.tutsplus.com/collision-detection-using-the-separating-axis-theorem--gamedev-169t
-
-// Narrow check
-bool sat_collision_check(Entity e1, Entity e2, float& displacement) {
-	Motion& m1 = registry.motions.get(e1);
-	Motion& m2 = registry.motions.get(e2);
-
-	std::vector<vec2> e1_pts;
-	std::vector<vec2> e2_pts;
-
-	if (registry.meshPtrs.has(e1)) {
-		// Get all vertices of the convex hull for entity1
-		Transform t;
-		t.rotate(m1.look_angle);
-		t.scale(m1.scale);
-
-		std::vector<ColoredVertex>& vertices = registry.meshPtrs.get(e1)->vertices;
-
-		for (int i = 0; i < vertices.size(); i++) {
-			vec3 vert = t.mat * vec3({ vertices[i].position.x, vertices[i].position.y, 0.0f });
-			vert += vec3({ m1.position.x, m1.position.y, 0.f });
-			e1_pts.push_back({vert.x, vert.y});
-		}
-
-	} else {
-		e1_pts.push_back(vec2({ m1.position.x - m1.scale.x / 2, m1.position.y - m1.scale.y / 2 })); // top-left
-		e1_pts.push_back(vec2({ m1.position.x + m1.scale.x / 2, m1.position.y - m1.scale.y / 2 })); // top-right
-		e1_pts.push_back(vec2({ m1.position.x + m1.scale.x / 2, m1.position.y + m1.scale.y / 2 })); // bottom-right
-		e1_pts.push_back(vec2({ m1.position.x - m1.scale.x / 2, m1.position.y + m1.scale.y / 2 })); // bottom-left
-	}
-
-	// Get vertices of the convex hull for entity2
-	if (registry.meshPtrs.has(e2)) {
-		std::vector<ColoredVertex>& vertices = registry.meshPtrs.get(e2)->vertices;
-		Transform t;
-		t.rotate(m2.look_angle);
-		t.scale(m2.scale);
-
-		for (int i = 0; i < vertices.size(); i++) {
-			vec3 vert = t.mat * vec3({ vertices[i].position.x, -vertices[i].position.y, 0.0f });
-			vert += vec3({ m2.position.x, m2.position.y, 0.f });
-			e2_pts.push_back({ vert.x, vert.y });
-		}
-
-	} else {
-		e2_pts.push_back(vec2({ m2.position.x - m2.scale.x / 2, m2.position.y - m2.scale.y / 2 })); // top-left
-		e2_pts.push_back(vec2({ m2.position.x + m2.scale.x / 2, m2.position.y - m2.scale.y / 2 })); // top-right
-		e2_pts.push_back(vec2({ m2.position.x + m2.scale.x / 2, m2.position.y + m2.scale.y / 2 })); // bottom-right
-		e2_pts.push_back(vec2({ m2.position.x - m2.scale.x / 2, m2.position.y + m2.scale.y / 2 })); // bottom-left
-	}
-
-	std::vector<vec2> e1_normals;
-	std::vector<vec2> e2_normals;
-
-	// Get the left-normals of each face of the convex hull (since the vertices are in clockwise order)
-	for (int i = 0; i < e1_pts.size(); i++) {
-		vec2& p1 = e1_pts[i];
-		vec2& p2 = e1_pts[(i + 1) % e1_pts.size()];
-		
-		e1_normals.push_back(vec2({ -(p2.y - p1.y), p2.x - p1.x }));
-	}
-
-	for (int i = 0; i < e2_pts.size(); i++) {
-		vec2& p1 = e2_pts[i];
-		vec2& p2 = e2_pts[(i + 1) % e2_pts.size()];
-
-		e2_normals.push_back(vec2({ -(p2.y - p1.y), p2.x - p1.x }));
-	}
-
-	if (registry.players.has(e1) && registry.obstacles.has(e2)) {
-		int x = 1;
-	}
-
-	float min_e1;
-	float max_e1;
-	float min_e2;
-	float max_e2;
-
-	// Check for SAT collision with normals of entity1
-	for (vec2& n : e1_normals) {
-		min_e1 = INFINITY;
-		max_e1 = -INFINITY;
-		min_e2 = INFINITY;
-		max_e2 = -INFINITY;
-
-		for (int i = 0; i < e1_pts.size(); i++) {
-			float dot_prod = e1_pts[i].x * n.x + e1_pts[i].y * n.y;
-			min_e1 = min(dot_prod, min_e1);
-			max_e1 = max(dot_prod, max_e1);
-		}
-
-		for (int i = 1; i < e2_pts.size(); i++) {
-			float dot_prod = e2_pts[i].x * n.x + e2_pts[i].y * n.y;
-			min_e2 = min(dot_prod, min_e2);
-			max_e2 = max(dot_prod, max_e2);
-		}
-		
-		displacement = min(displacement, min(max_e1, max_e2) - max(min_e1, min_e2));
-
-		// We can draw a line between the two entities, return no collision
-		if (min_e1 > max_e2 || min_e2 > max_e1) {
-			return false;
-		}
-	}
-
-	// Check for SAT collision with normals from entity2
-	for (vec2& n : e2_normals) {
-		min_e1 = INFINITY;
-		max_e1 = -INFINITY;
-		min_e2 = INFINITY;
-		max_e2 = -INFINITY;
-
-		for (int i = 0; i < e1_pts.size(); i++) {
-			float dot_prod = e1_pts[i].x * n.x + e1_pts[i].y * n.y;
-			min_e1 = min(dot_prod, min_e1);
-			max_e1 = max(dot_prod, max_e1);
-		}
-
-		for (int i = 1; i < e2_pts.size(); i++) {
-			float dot_prod = e2_pts[i].x * n.x + e2_pts[i].y * n.y;
-			min_e2 = min(dot_prod, min_e2);
-			max_e2 = max(dot_prod, max_e2);
-		}
-		
-		displacement = min(displacement, min(max_e1, max_e2) - max(min_e1, min_e2));
-
-		// We can draw a line between the two entities, return no collision
-		if (min_e1 > max_e2 || min_e2 > max_e1) {
-			return false;
-		}
-	}
-
-	return true;
- }
-
 // Broad check
  bool aabb_collision_check(const Motion& motion1, const Motion& motion2) {
 	 const float& x1 = motion1.position.x;
@@ -323,26 +63,107 @@ bool sat_collision_check(Entity e1, Entity e2, float& displacement) {
 		 (x2 - 0.5f * w2 < x1 + 0.5f * w1 && y2 - 0.5f * h2 < y1 + 0.5f * h1);
 }
 
-// Returns whether two entities collide based on AABB collision detection
-bool collides(const Entity entity1, const Entity entity2, float& displacement)
+// Swept AABB test for entities flagged as fast, so they cannot tunnel through an entity between two steps.
+// Both boxes move from where they were at the start of the step (previous_position, for fast motions only)
+// to their current position, returns the first time of contact in [0, 1] and the normal of the face hit by motion1.
+// Boxes that already overlap at the start of the step hit no face, the normal stays zero for them.
+bool swept_aabb_collision_check(const Motion& motion1, const Motion& motion2, float& time_of_impact, vec2& normal)
+{
+	vec2 start1 = motion1.fast ? motion1.previous_position : motion1.position;
+	vec2 start2 = motion2.fast ? motion2.previous_position : motion2.position;
+	// movement of box 1 relative to box 2, against box 2 grown by the half size of box 1
+	vec2 delta = (motion1.position - start1) - (motion2.position - start2);
+	vec2 half = 0.5f * (abs(motion1.scale) + abs(motion2.scale));
+
+	float t_enter = 0.f;
+	float t_exit = 1.f;
+	normal = { 0, 0 };
+	for (int axis = 0; axis < 2; axis++) {
+		float low = start2[axis] - half[axis] - start1[axis];
+		float high = start2[axis] + half[axis] - start1[axis];
+		if (abs(delta[axis]) < 1e-6f) {
+			// no movement on this axis, the boxes have to overlap on it already
+			if (low >= 0.f || high <= 0.f) {
+				return false;
+			}
+			continue;
+		}
+		float t_low = low / delta[axis];
+		float t_high = high / delta[axis];
+		if (t_low > t_high) {
+			std::swap(t_low, t_high);
+		}
+		if (t_low > t_enter) {
+			t_enter = t_low;
+			normal = { 0, 0 };
+			normal[axis] = delta[axis] > 0.f ? -1.f : 1.f;
+		}
+		t_exit = min(t_exit, t_high);
+		if (t_enter >= t_exit) {
+			return false;
+		}
+	}
+
+	time_of_impact = t_enter;
+	return true;
+}
+
+// Corners of a bounding box, in polygon order for the SAT test
+void get_box_corners(vec2 position, vec2 scale, vec2 corners[4])
+{
+	vec2 half = 0.5f * abs(scale);
+	corners[0] = { position.x - half.x, position.y - half.y }; // top-left
+	corners[1] = { position.x + half.x, position.y - half.y }; // top-right
+	corners[2] = { position.x + half.x, position.y + half.y }; // bottom-right
+	corners[3] = { position.x - half.x, position.y + half.y }; // bottom-left
+}
+
+void get_box_corners(const Motion& motion, vec2 corners[4])
+{
+	get_box_corners(motion.position, motion.scale, corners);
+}
+
+// Returns whether two entities collide, and if so how entity1 has to move to get out of entity2.
+// The hulls are the cached game space meshes of the entities or nullptr for entities without a mesh
+bool collides(const Entity entity1, const Entity entity2, const CollisionHull* hull1, const CollisionHull* hull2, Contact& contact)
 {
 	Motion& m1 = registry.motions.get(entity1);
 	Motion& m2 = registry.motions.get(entity2);
 
 	if (!aabb_collision_check(m1, m2)) {
-		return false;
+		// the end poses are apart, but a fast entity may have passed through the other during the step
+		float time_of_impact;
+		if (!(m1.fast || m2.fast) || !swept_aabb_collision_check(m1, m2, time_of_impact, contact.normal)) {
+			return false;
+		}
+		if (contact.normal != vec2(0.f)) {
+			contact.depth = 0.f;
+			return true;
+		}
+		// the boxes overlapped when the step started, separate them by the MTV of their start boxes
+		vec2 start1[4], start2[4];
+		get_box_corners(m1.fast ? m1.previous_position : m1.position, m1.scale, start1);
+		get_box_corners(m2.fast ? m2.previous_position : m2.position, m2.scale, start2);
+		return sat_collision(ConvexShape{ start1, 4 }, ConvexShape{ start2, 4 }, contact);
 	}
 
-	if (registry.meshPtrs.has(entity1) && registry.meshPtrs.has(entity2)) {
-		return mesh_to_mesh_collision_check(entity1, entity2);
-	} else if (registry.meshPtrs.has(entity1) && !registry.meshPtrs.has(entity2)) {
-		return mesh_to_box_collision_check(entity1, entity2);
-	} else if (!registry.meshPtrs.has(entity1) && registry.meshPtrs.has(entity2)) {
-		return mesh_to_box_collision_check(entity2, entity1);
+	vec2 box1[4], box2[4];
+	get_box_corners(m1, box1);
+	get_box_corners(m2, box2);
+	ConvexShape shape1 = hull1 ? ConvexShape{ hull1->vertices.data(), (unsigned int)hull1->vertices.size() } : ConvexShape{ box1, 4 };
+	ConvexShape shape2 = hull2 ? ConvexShape{ hull2->vertices.data(), (unsigned int)hull2->vertices.size() } : ConvexShape{ box2, 4 };
+
+	if (!hull1 && !hull2) {
+		return sat_collision(shape1, shape2, contact);
 	}
 
-	return true;
-	//return sat_collision_check(entity1, entity2, displacement);
+	// The hull bounds are tighter than the scale of a motion, reject before running GJK
+	vec2 min1 = hull1 ? hull1->min : box1[0], max1 = hull1 ? hull1->max : box1[2];
+	vec2 min2 = hull2 ? hull2->min : box2[0], max2 = hull2 ? hull2->max : box2[2];
+	if (max1.x < min2.x || max2.x < min1.x || max1.y < min2.y || max2.y < min1.y) {
+		return false;
+	}
+	return gjk_collision(shape1, shape2, contact);
 }
 
 
@@ -353,10 +174,11 @@ const float yMax = 992.0f;
 void update_motion(Motion &motion, float step_seconds)
 {
 	// TODO: Update position with motion here
+	motion.previous_position = motion.position;
+	motion.previous_look_angle = motion.look_angle;
+
 	if (!motion.complex)
 	{
-		motion.previous_position = motion.position;
-
 		motion.look_angle += motion.turn_speed * step_seconds;
 		if (motion.look_angle > M_PI)
 		{
@@ -451,8 +273,6 @@ void update_motion(Motion &motion, float step_seconds)
 	}
 
 	// Update position
-	motion.previous_position = motion.position;
-
 	motion.position.x += motion.velocity.x * step_seconds;
 	motion.position.y += motion.velocity.y * step_seconds;
 
@@ -464,6 +284,8 @@ void update_motion(Motion &motion, float step_seconds)
 
 void PhysicsSystem::step(float elapsed_ms)
 {
+	PROFILE_SCOPE("physics.step");
+
 	// Move entity with motion based on how much time has passed, this is to (partially) avoid
 	// having entities move at different speed based on the machine.
 	auto &motion_registry = registry.motions;
@@ -478,40 +300,64 @@ void PhysicsSystem::step(float elapsed_ms)
 	}
 
 	// Check for collisions between all moving entities
-	float displacement_scalar = INFINITY;
-
-	ComponentContainer<Motion> &motion_container = registry.motions;
-	for (uint i = 0; i < motion_container.components.size(); i++)
-	{
-		Motion &motion_i = motion_container.components[i];
-		Entity entity_i = motion_container.entities[i];
+	// Drop the cached hulls of entities that were destroyed or lost their mesh
+	for (size_t i = hulls.entities.size(); i-- > 0;) {
+		Entity entity = hulls.entities[i];
+		if (!registry.meshPtrs.has(entity))
+			hulls.remove(entity);
+	}
 
-		if (registry.noCollisionChecks.has(entity_i)) {
-			continue;
+	// Gather the colliding entities once instead of probing noCollisionChecks for every pair
+	colliders.clear();
+	collider_boxes.clear();
+	collider_hulls.clear();
+	registry.view<Motion>(exclude<NoCollisionCheck>).each([this](Entity entity, Motion& motion) {
+		// UI and effects collide with no layer, they never enter the grid
+		if (motion.collision_mask == COLLISION_LAYER::NONE)
+			return;
+		vec2 half_extent = 0.5f * abs(motion.scale);
+		colliders.push_back(entity);
+		if (motion.fast) {
+			// fast entities cover the whole distance travelled in this step
+			collider_boxes.push_back({ min(motion.previous_position, motion.position) - half_extent, max(motion.previous_position, motion.position) + half_extent, motion.collision_layer, motion.collision_mask });
+		}
+		else {
+			collider_boxes.push_back({ motion.position - half_extent, motion.position + half_extent, motion.collision_layer, motion.collision_mask });
 		}
 
-		// note starting j at i+1 to compare all (i,j) pairs only once (and to not compare with itself)
-		for (uint j = i + 1; j < motion_container.components.size(); j++)
+		// Transform the mesh once per step, not once per pair it is tested against
+		if (Mesh** mesh = registry.meshPtrs.try_get(entity)) {
+			CollisionHull* hull = hulls.try_get(entity);
+			update_hull(hull ? *hull : hulls.emplace(entity), **mesh, motion);
+		}
+	});
+	// the hulls container is done growing, pointers into it stay valid for the pair loop
+	for (Entity entity : colliders)
+		collider_hulls.push_back(hulls.try_get(entity));
+
+	// Broadphase, only entities that share a grid cell, collide by layer and whose bounding boxes overlap are paired up
+	grid.build(collider_boxes);
+	grid.for_each_pair([this](unsigned int i, unsigned int j) {
+		// i < j, so pairs keep the collider order of the previous all-pairs loop
+		Entity entity_i = colliders[i];
+		Entity entity_j = colliders[j];
+
+		Contact contact;
+		if (collides(entity_i, entity_j, collider_hulls[i], collider_hulls[j], contact))
 		{
-			displacement_scalar = INFINITY;
-			Entity entity_j = motion_container.entities[j];	
-
-			if (registry.noCollisionChecks.has(entity_j)) {
-				continue;
-			}
-
-			if (collides(entity_i, entity_j, displacement_scalar))
-			{
-				// Create a collisions event
-				// We are abusing the ECS system a bit in that we potentially insert muliple collisions for the same entity
-				Collision& collision1 = registry.collisions.emplace_with_duplicates(entity_i, entity_j);
-				Collision& collision2 = registry.collisions.emplace_with_duplicates(entity_j, entity_i);
-
-				if (registry.players.has(entity_i) && registry.obstacles.has(entity_j)) {
-					collision1.scalar = displacement_scalar;
-					collision2.scalar = displacement_scalar;
-				}
-			}
+			// Create a collisions event
+			// We are abusing the ECS system a bit in that we potentially insert muliple collisions for the same entity
+			// each record gets the translation that moves its own entity out of the other,
+			// fill the first one before the second emplace can move it
+			Collision& collision1 = registry.collisions.emplace_with_duplicates(entity_i, entity_j);
+			collision1.normal = contact.normal;
+			collision1.depth = contact.depth;
+			collision1.position = registry.motions.get(entity_i).position;
+
+			Collision& collision2 = registry.collisions.emplace_with_duplicates(entity_j, entity_i);
+			collision2.normal = -contact.normal;
+			collision2.depth = contact.depth;
+			collision2.position = registry.motions.get(entity_j).position;
 		}
-	}
+	});
 }
\ No newline at end of file
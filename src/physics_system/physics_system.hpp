@@ -4,6 +4,20 @@
 #include "ecs/ecs.hpp"
 #include "components/components.hpp"
 #include "ecs_registry/ecs_registry.hpp"
+#include "physics_system/spatial_grid.hpp"
+
+// Game space vertices and bounds of the mesh of an entity, kept between steps and only
+// re-transformed when the position, angle or scale of the entity changed
+struct CollisionHull
+{
+	const Mesh* mesh = nullptr;
+	vec2 position = { 0, 0 };
+	float angle = 0;
+	vec2 scale = { 0, 0 };
+	std::vector<vec2> vertices;
+	vec2 min = { 0, 0 };
+	vec2 max = { 0, 0 };
+};
 
 // A simple physics system that moves rigid bodies and checks for collision
 class PhysicsSystem
@@ -14,4 +28,13 @@ public:
 	PhysicsSystem()
 	{
 	}
+
+private:
+	// Broadphase state, kept between steps to reuse the allocations
+	SpatialGrid grid;
+	std::vector<Entity> colliders;
+	std::vector<SpatialGrid::Box> collider_boxes;
+	// Narrowphase state, hulls of the entities with a mesh and the hull of each collider (nullptr for boxes)
+	ComponentContainer<CollisionHull> hulls;
+	std::vector<CollisionHull*> collider_hulls;
 };
\ No newline at end of file
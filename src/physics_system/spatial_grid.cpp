@@ -0,0 +1,28 @@
+// internal
+#include "physics_system/spatial_grid.hpp"
+
+void SpatialGrid::build(const std::vector<Box>& boxes)
+{
+	this->boxes = &boxes;
+
+	// Counting sort of the boxes into the cells: count, prefix sum, fill
+	cell_start.assign(columns * rows + 1, 0);
+	for (const Box& box : boxes)
+	{
+		for (int y = cell_y(box.min.y); y <= cell_y(box.max.y); y++)
+			for (int x = cell_x(box.min.x); x <= cell_x(box.max.x); x++)
+				cell_start[y * columns + x + 1]++;
+	}
+	for (int cell = 0; cell < columns * rows; cell++)
+		cell_start[cell + 1] += cell_start[cell];
+
+	entries.resize(cell_start[columns * rows]);
+	cursor.assign(cell_start.begin(), cell_start.end() - 1);
+	for (unsigned int i = 0; i < boxes.size(); i++)
+	{
+		const Box& box = boxes[i];
+		for (int y = cell_y(box.min.y); y <= cell_y(box.max.y); y++)
+			for (int x = cell_x(box.min.x); x <= cell_x(box.max.x); x++)
+				entries[cursor[y * columns + x]++] = i;
+	}
+}
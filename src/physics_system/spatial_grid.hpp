@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+
+#include "common/common.hpp"
+
+// Uniform grid broadphase covering the window, with cells of game_window_block_size pixels so that
+// one cell of the grid is one block of the room. Boxes are bucketed into every cell they overlap and
+// only boxes sharing a cell are paired, instead of testing every pair of moving entities.
+// The grid is rebuilt from scratch every step, its buffers are kept between steps so this does not allocate.
+class SpatialGrid
+{
+public:
+	struct Box
+	{
+		vec2 min;
+		vec2 max;
+		// collision layer bit and mask of the owner, see COLLISION_LAYER
+		unsigned int layer = ~0u;
+		unsigned int mask = ~0u;
+	};
+
+	static const int cell_size = game_window_block_size;
+	static const int columns = (window_width_px + cell_size - 1) / cell_size;
+	static const int rows = (window_height_px + cell_size - 1) / cell_size;
+
+	// Bucket the boxes by cell, a box is referred to by its index in 'boxes'
+	void build(const std::vector<Box>& boxes);
+
+	// Calls func(i, j) with i < j once for every pair of boxes that overlap and whose layers collide
+	template <typename Func>
+	void for_each_pair(Func func) const
+	{
+		for (int cell = 0; cell < columns * rows; cell++)
+		{
+			const unsigned int begin = cell_start[cell];
+			const unsigned int end = cell_start[cell + 1];
+			for (unsigned int a = begin; a < end; a++)
+			{
+				const unsigned int i = entries[a];
+				for (unsigned int b = a + 1; b < end; b++)
+				{
+					const unsigned int j = entries[b];
+					// the layer test is a single AND per side, it rejects most pairs before any geometry
+					if (!layers_collide(i, j))
+						continue;
+					// boxes spanning several cells meet in more than one, only report the pair in the
+					// cell that holds the top-left corner of their overlap
+					if (overlaps(i, j) && owner_cell(i, j) == cell)
+						func(i, j);
+				}
+			}
+		}
+	}
+
+private:
+	const std::vector<Box>* boxes = nullptr;
+	// entries[cell_start[c] .. cell_start[c + 1]) are the boxes in cell c, in ascending box order
+	std::vector<unsigned int> cell_start;
+	std::vector<unsigned int> cursor;
+	std::vector<unsigned int> entries;
+
+	static int cell_x(float x) { return clamp((int)floor(x / cell_size), 0, columns - 1); }
+	static int cell_y(float y) { return clamp((int)floor(y / cell_size), 0, rows - 1); }
+
+	bool layers_collide(unsigned int i, unsigned int j) const
+	{
+		const Box& b1 = (*boxes)[i];
+		const Box& b2 = (*boxes)[j];
+		return (b1.layer & b2.mask) && (b2.layer & b1.mask);
+	}
+
+	bool overlaps(unsigned int i, unsigned int j) const
+	{
+		const Box& b1 = (*boxes)[i];
+		const Box& b2 = (*boxes)[j];
+		return b1.min.x < b2.max.x && b2.min.x < b1.max.x && b1.min.y < b2.max.y && b2.min.y < b1.max.y;
+	}
+
+	int owner_cell(unsigned int i, unsigned int j) const
+	{
+		const Box& b1 = (*boxes)[i];
+		const Box& b2 = (*boxes)[j];
+		return cell_y(max(b1.min.y, b2.min.y)) * columns + cell_x(max(b1.min.x, b2.min.x));
+	}
+};
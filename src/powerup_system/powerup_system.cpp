@@ -3,9 +3,10 @@
 #include <ecs_registry/ecs_registry.hpp>
 #include <world_init/world_init.hpp>
 #include <render_system/render_system.hpp>
+#include <random_service/random_service.hpp>
 
 // stlib
-#include <random>
+#include <algorithm>
 
 void PowerupSystem::init(RenderSystem* renderer_arg)
 {
@@ -111,7 +112,7 @@ void PowerupSystem::destroyPopup() {
 	registry.remove_all_components_of(currentPowerupPopupDescriptionText);
 }
 
-void PowerupSystem::awardPowerup(Entity entity, std::default_random_engine rng, std::uniform_real_distribution<float> uniform_dist)
+void PowerupSystem::awardPowerup(Entity entity)
 {
 	Player& player = registry.players.get(entity);
 	player.powerups_collected++;
@@ -151,8 +152,7 @@ void PowerupSystem::awardPowerup(Entity entity, std::default_random_engine rng,
 
 	if (powerups_not_collected.size() > 0) {
 		// maybe we should give certain powerups a higher chance of spawning than others
-		std::uniform_int_distribution<int> powerup_dist(0, powerups_not_collected.size() - 1);
-		PowerupType powerup = powerups_not_collected[powerup_dist(rng)];
+		PowerupType powerup = powerups_not_collected[random_service.range(RANDOM_STREAM::LOOT, 0, powerups_not_collected.size() - 1)];
 		player.powerups.push_back(powerup);
 		Motion& playerMotion = registry.motions.get(entity);
 		switch (powerup) {
@@ -5,8 +5,6 @@
 #include "components/components.hpp"
 #include "render_system/render_system.hpp"
 
-#include <random>
-
 class PowerupSystem
 {
 	RenderSystem* renderer;
@@ -18,5 +16,5 @@ public:
 	void init(RenderSystem* renderer);
 	void createPopup(PowerupType powerup);
 	void destroyPopup();
-	void awardPowerup(Entity entity, std::default_random_engine rng, std::uniform_real_distribution<float> uniform_dist);
+	void awardPowerup(Entity entity);
 };
\ No newline at end of file
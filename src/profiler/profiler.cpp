@@ -0,0 +1,166 @@
+// internal
+#include "profiler/profiler.hpp"
+
+// stlib
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+Profiler profiler;
+
+int Profiler::section(const char* name)
+{
+	for (int i = 0; i < (int)sections.size(); i++) {
+		if (sections[i].name == name)
+			return i;
+	}
+	sections.emplace_back();
+	sections.back().name = name;
+	sections.back().depth = depth;
+	return (int)sections.size() - 1;
+}
+
+void Profiler::begin_frame()
+{
+	frame_start = Clock::now();
+	for (Section& section : sections)
+		section.frame_ms = 0.f;
+}
+
+void Profiler::end_frame()
+{
+	float frame_ms = std::chrono::duration<float, std::milli>(Clock::now() - frame_start).count();
+
+	frame_history[history_index] = frame_ms;
+	for (Section& section : sections)
+		section.history[history_index] = section.frame_ms;
+	history_index = (history_index + 1) % history_length;
+	if (history_size < history_length)
+		history_size++;
+
+	if (capturing) {
+		captured_frames.emplace_back();
+		std::vector<float>& row = captured_frames.back();
+		row.reserve(sections.size() + 1);
+		for (const Section& section : sections)
+			row.push_back(section.frame_ms);
+		row.push_back(frame_ms);
+	}
+}
+
+void Profiler::record(int section, Clock::time_point start, Clock::time_point end)
+{
+	float duration_ms = std::chrono::duration<float, std::milli>(end - start).count();
+	sections[section].frame_ms += duration_ms;
+
+	if (capturing && trace_events.size() < max_trace_events) {
+		double start_us = std::chrono::duration<double, std::micro>(start - profiler_start).count();
+		trace_events.push_back({ section, start_us, duration_ms * 1000.f });
+	}
+}
+
+Profiler::Stats Profiler::history_stats(const float* history) const
+{
+	Stats stats;
+	if (history_size == 0)
+		return stats;
+
+	float sorted[history_length];
+	std::copy(history, history + history_size, sorted);
+	std::sort(sorted, sorted + history_size);
+
+	float sum = 0.f;
+	for (int i = 0; i < history_size; i++)
+		sum += sorted[i];
+	stats.min_ms = sorted[0];
+	stats.avg_ms = sum / history_size;
+	stats.p99_ms = sorted[std::min(history_size - 1, (int)(history_size * 0.99f))];
+	stats.max_ms = sorted[history_size - 1];
+	return stats;
+}
+
+Profiler::Stats Profiler::section_stats(int section) const
+{
+	return history_stats(sections[section].history);
+}
+
+Profiler::Stats Profiler::frame_stats() const
+{
+	return history_stats(frame_history);
+}
+
+bool Profiler::save_csv(const std::string& path) const
+{
+	std::ofstream out(path);
+	if (!out.is_open()) {
+		std::cerr << "could not write profile " << path << std::endl;
+		return false;
+	}
+
+	out << "frame";
+	for (const Section& section : sections)
+		out << "," << section.name << "_ms";
+	out << ",frame_ms\n";
+	for (size_t f = 0; f < captured_frames.size(); f++) {
+		const std::vector<float>& row = captured_frames[f];
+		out << f;
+		// sections registered after this frame did not run in it
+		for (size_t i = 0; i < sections.size(); i++)
+			out << "," << (i + 1 < row.size() ? row[i] : 0.f);
+		out << "," << row.back() << "\n";
+	}
+	return out.good();
+}
+
+void Profiler::print_summary() const
+{
+	if (captured_frames.empty())
+		return;
+
+	std::cout << std::fixed << std::setprecision(4);
+	std::cout << std::left << std::setw(32) << "section" << std::right << std::setw(10) << "avg(ms)"
+		<< std::setw(10) << "p99(ms)" << std::setw(10) << "max(ms)" << std::endl;
+	std::vector<float> times(captured_frames.size());
+	for (size_t i = 0; i <= sections.size(); i++) {
+		for (size_t f = 0; f < captured_frames.size(); f++) {
+			const std::vector<float>& row = captured_frames[f];
+			// the last column is the whole frame
+			if (i == sections.size())
+				times[f] = row.back();
+			else
+				times[f] = i + 1 < row.size() ? row[i] : 0.f;
+		}
+		std::sort(times.begin(), times.end());
+		float sum = 0.f;
+		for (float ms : times)
+			sum += ms;
+
+		std::string name = i == sections.size() ? "frame" : std::string(2 * sections[i].depth, ' ') + sections[i].name;
+		std::cout << std::left << std::setw(32) << name << std::right
+			<< std::setw(10) << sum / times.size()
+			<< std::setw(10) << times[std::min(times.size() - 1, (size_t)(times.size() * 0.99f))]
+			<< std::setw(10) << times.back() << std::endl;
+	}
+	std::cout << std::defaultfloat;
+}
+
+bool Profiler::save_chrome_trace(const std::string& path) const
+{
+	std::ofstream out(path);
+	if (!out.is_open()) {
+		std::cerr << "could not write trace " << path << std::endl;
+		return false;
+	}
+
+	out << std::fixed << std::setprecision(3);
+	out << "{\"traceEvents\":[\n";
+	for (size_t i = 0; i < trace_events.size(); i++) {
+		const TraceEvent& event = trace_events[i];
+		out << "{\"name\":\"" << sections[event.section].name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+			<< ",\"ts\":" << event.start_us << ",\"dur\":" << event.duration_us << "}"
+			<< (i + 1 < trace_events.size() ? ",\n" : "\n");
+	}
+	out << "],\"displayTimeUnit\":\"ms\"}\n";
+	return out.good();
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+// stlib
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Frame profiler.
+// PROFILE_SCOPE("name") times the rest of the enclosing block as the section "name".
+// The time of every section is summed per frame, between begin_frame() and end_frame() of the main loop,
+// and kept for the last frames for the overlay (min / avg / p99).
+// While capturing, every frame is also kept for the CSV export and every timed scope for the Chrome trace
+// (open the json in chrome://tracing or https://ui.perfetto.dev).
+class Profiler
+{
+public:
+	using Clock = std::chrono::high_resolution_clock;
+
+	// statistics over the frames in the history
+	struct Stats
+	{
+		float min_ms = 0.f;
+		float avg_ms = 0.f;
+		float p99_ms = 0.f;
+		float max_ms = 0.f;
+	};
+
+	// Returns the id of the section with this name, registers it the first time
+	int section(const char* name);
+
+	void begin_frame();
+	void end_frame();
+
+	// Adds one timed scope of a section to the current frame
+	void record(int section, Clock::time_point start, Clock::time_point end);
+
+	int section_count() const { return (int)sections.size(); }
+	const std::string& section_name(int section) const { return sections[section].name; }
+	// nesting depth of the section the first time it was timed
+	int section_depth(int section) const { return sections[section].depth; }
+	Stats section_stats(int section) const;
+	Stats frame_stats() const;
+
+	// Starts keeping every frame and scope for save_csv() and save_chrome_trace()
+	void start_capture() { capturing = true; }
+	// One row per frame, the time of every section in milliseconds
+	bool save_csv(const std::string& path) const;
+	// Chrome trace event format, one complete event per timed scope
+	bool save_chrome_trace(const std::string& path) const;
+	// Mean, p99 and worst time of every section over all captured frames
+	void print_summary() const;
+
+	// Current nesting depth of the timed scopes, maintained by ProfileScope
+	int depth = 0;
+
+private:
+	static const int history_length = 240;
+	// at most this many scopes are kept for the trace, about 16 MB
+	static const size_t max_trace_events = 1 << 20;
+
+	struct Section
+	{
+		std::string name;
+		int depth = 0;
+		float frame_ms = 0.f;
+		float history[history_length] = {};
+	};
+
+	struct TraceEvent
+	{
+		int section;
+		double start_us;
+		float duration_us;
+	};
+
+	std::vector<Section> sections;
+	float frame_history[history_length] = {};
+	int history_index = 0;
+	int history_size = 0;
+	Clock::time_point frame_start;
+	Clock::time_point profiler_start = Clock::now();
+
+	bool capturing = false;
+	std::vector<std::vector<float>> captured_frames;
+	std::vector<TraceEvent> trace_events;
+
+	Stats history_stats(const float* history) const;
+};
+
+extern Profiler profiler;
+
+// Times its lifetime as one scope of a section, use PROFILE_SCOPE
+class ProfileScope
+{
+	int section;
+	Profiler::Clock::time_point start;
+
+public:
+	ProfileScope(int section) : section(section), start(Profiler::Clock::now()) { profiler.depth++; }
+	~ProfileScope()
+	{
+		profiler.depth--;
+		profiler.record(section, start, Profiler::Clock::now());
+	}
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+// The section is looked up once per call site
+#define PROFILE_SCOPE(name) \
+	static const int PROFILE_CONCAT(profile_section_, __LINE__) = profiler.section(name); \
+	ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(PROFILE_CONCAT(profile_section_, __LINE__))
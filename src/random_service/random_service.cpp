@@ -0,0 +1,75 @@
+// internal
+#include "random_service/random_service.hpp"
+
+RandomService random_service;
+
+// splitmix64, spreads consecutive inputs over the whole seed space
+static uint64_t mix_seed(uint64_t x)
+{
+	x += 0x9E3779B97F4A7C15ull;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+	return x ^ (x >> 31);
+}
+
+uint64_t random_session_seed()
+{
+	std::random_device device;
+	return ((uint64_t)device() << 32) | device();
+}
+
+RandomService::RandomService()
+{
+	seed(0);
+}
+
+void RandomService::seed(uint64_t seed)
+{
+	session_seed = seed;
+	run_count = 0;
+	reseed_streams(mix_seed(session_seed));
+}
+
+void RandomService::start_run()
+{
+	reseed_streams(mix_seed(session_seed + run_count));
+	run_count++;
+}
+
+void RandomService::reseed_streams(uint64_t run_seed)
+{
+	current_run_seed = run_seed;
+	for (int i = 0; i < stream_count; i++) {
+		uint64_t stream_seed = mix_seed(run_seed + i);
+		std::seed_seq sequence = { (uint32_t)stream_seed, (uint32_t)(stream_seed >> 32) };
+		streams[i].seed(sequence);
+	}
+}
+
+std::mt19937& RandomService::stream(RANDOM_STREAM stream)
+{
+	return streams[(int)stream];
+}
+
+float RandomService::uniform(RANDOM_STREAM stream)
+{
+	// the top 24 bits fill the float mantissa exactly
+	return (streams[(int)stream]() >> 8) * (1.f / 16777216.f);
+}
+
+float RandomService::uniform(RANDOM_STREAM stream, float min, float max)
+{
+	return min + uniform(stream) * (max - min);
+}
+
+int RandomService::range(RANDOM_STREAM stream, int min, int max)
+{
+	uint32_t span = (uint32_t)(max - min) + 1;
+	// the modulo bias is below 1e-8 for the small ranges the game uses
+	return min + (int)(streams[(int)stream]() % span);
+}
+
+bool RandomService::chance(RANDOM_STREAM stream, float probability)
+{
+	return uniform(stream) < probability;
+}
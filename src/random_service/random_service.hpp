@@ -0,0 +1,60 @@
+#pragma once
+
+// stlib
+#include <cstdint>
+#include <random>
+
+// Named random streams, each system draws from its own so that e.g. firing more bullets
+// does not change the rooms that are generated
+enum class RANDOM_STREAM
+{
+	WORLDGEN = 0,	// room layouts, room types, enemy types of a room
+	COMBAT = 1,		// weapon spread
+	AI = 2,			// enemy decisions, boss minion types
+	LOOT = 3,		// powerup drops and rolls, shop offers
+	STREAM_COUNT = 4
+};
+const int stream_count = (int)RANDOM_STREAM::STREAM_COUNT;
+
+// Central source of randomness, every random decision of the game goes through it.
+// A session is started from a single seed, each run (restart of the game) reseeds all streams
+// from that seed and the run number, so a whole session can be replayed bit-exactly from the seed.
+// std::mt19937 and the helpers below give the same sequence with every standard library,
+// unlike std::default_random_engine and the std distributions.
+class RandomService
+{
+	uint64_t session_seed = 0;
+	uint64_t current_run_seed = 0;
+	unsigned int run_count = 0;
+	std::mt19937 streams[stream_count];
+
+	void reseed_streams(uint64_t run_seed);
+
+public:
+	RandomService();
+
+	// Starts a new session, the streams are set up for its first run
+	void seed(uint64_t seed);
+	// Reseeds all streams for the next run of the session
+	void start_run();
+
+	uint64_t get_session_seed() const { return session_seed; }
+	uint64_t get_run_seed() const { return current_run_seed; }
+
+	// Engine of a stream, for code that needs a std::shuffle or std distribution
+	std::mt19937& stream(RANDOM_STREAM stream);
+
+	// Number in [0, 1)
+	float uniform(RANDOM_STREAM stream);
+	// Number in [min, max)
+	float uniform(RANDOM_STREAM stream, float min, float max);
+	// Integer in [min, max]
+	int range(RANDOM_STREAM stream, int min, int max);
+	// true with the given probability
+	bool chance(RANDOM_STREAM stream, float probability);
+};
+
+// A seed from the OS, for sessions that do not need to be replayed
+uint64_t random_session_seed();
+
+extern RandomService random_service;
@@ -2,7 +2,10 @@
 #include "render_system/render_system.hpp"
 #include <SDL.h>
 #include "ecs_registry/ecs_registry.hpp"
+#include "profiler/profiler.hpp"
 #include "common/common.hpp"
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
 
 // matrices
@@ -10,15 +13,47 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Frame of the animation to draw, the player's sprite follows the rotation_factor instead
+static int animationFrame(Entity entity, const Animation& animation)
+{
+	if (registry.players.has(entity)) {
+		// 12 frames in the player sprite sheet, one per 10 of the rotation factor
+		const Player& player = registry.players.get(entity);
+		return std::min(std::max((int)(player.rotation_factor / 10.f), 0), 11);
+	}
+	return (int)animation.current_frame;
+}
+
+Transform RenderSystem::interpolatedTransform(const Motion& motion) const
+{
+	// UI (e.g. the cursor) is moved outside of the physics step and a jump of more than a block
+	// (spawn, moving rooms) is a teleport, both are drawn at the new pose right away
+	vec2 position = motion.position;
+	float angle = motion.look_angle;
+	if (interpolation < 1.f && motion.collision_layer != COLLISION_LAYER::UI &&
+		distance(motion.previous_position, motion.position) < game_window_block_size) {
+		position = mix(motion.previous_position, motion.position, interpolation);
+		// turn the short way round when the angle wraps at pi
+		float turn = motion.look_angle - motion.previous_look_angle;
+		if (turn > M_PI)
+			turn -= 2 * M_PI;
+		else if (turn < -M_PI)
+			turn += 2 * M_PI;
+		angle = motion.look_angle - (1.f - interpolation) * turn;
+	}
+
+	Transform transform;
+	transform.translate(position);
+	transform.rotate(angle);
+	transform.scale(motion.scale);
+	return transform;
+}
+
 void RenderSystem::drawTexturedMesh(Entity entity,
 	const mat3& projection)
 {
 	Motion& motion = registry.motions.get(entity);
-	
-	Transform transform;
-	transform.translate(motion.position);
-	transform.rotate(motion.look_angle);
-	transform.scale(motion.scale);
+	Transform transform = interpolatedTransform(motion);
 
 	assert(registry.renderRequests.has(entity));
 	const RenderRequest& render_request = registry.renderRequests.get(entity);
@@ -158,50 +193,7 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 
 	if (registry.animations.has(entity)) {
 		Animation& animation = registry.animations.get(entity);
-		int current_frame;
-		if (registry.players.has(entity)) {
-			Player& player = registry.players.get(entity);
-			// 12 frames in the player sprite sheet
-			if (0 <= player.rotation_factor && player.rotation_factor < 10) {
-				current_frame = 0;
-			}
-			else if (10 <= player.rotation_factor && player.rotation_factor < 20) {
-				current_frame = 1;
-			}
-			else if (20 <= player.rotation_factor && player.rotation_factor < 30) {
-				current_frame = 2;
-			}
-			else if (30 <= player.rotation_factor && player.rotation_factor < 40) {
-				current_frame = 3;
-			}
-			else if (40 <= player.rotation_factor && player.rotation_factor < 50) {
-				current_frame = 4;
-			}
-			else if (50 <= player.rotation_factor && player.rotation_factor < 60) {
-				current_frame = 5;
-			}
-			else if (60 <= player.rotation_factor && player.rotation_factor < 70) {
-				current_frame = 6;
-			}
-			else if (70 <= player.rotation_factor && player.rotation_factor < 80) {
-				current_frame = 7;
-			}
-			else if (80 <= player.rotation_factor && player.rotation_factor < 90) {
-				current_frame = 8;
-			}
-			else if (90 <= player.rotation_factor && player.rotation_factor < 100) {
-				current_frame = 9;
-			}
-			else if (100 <= player.rotation_factor && player.rotation_factor < 110) {
-				current_frame = 10;
-			}
-			else if (110 <= player.rotation_factor && player.rotation_factor <= 120) {
-				current_frame = 11;
-			}
-		}
-		else {
-			current_frame = animation.current_frame;
-		}
+		int current_frame = animationFrame(entity, animation);
 
 		SPRITE_SHEET_ID sheet_id = animation.sheet_id;
 		std::pair<int, int> spriteLocation = animation.sprites[current_frame];
@@ -226,6 +218,97 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 	gl_has_errors();
 }
 
+GLuint RenderSystem::spriteTexture(Entity entity)
+{
+	const RenderRequest& render_request = registry.renderRequests.get(entity);
+	if (render_request.used_effect != EFFECT_ASSET_ID::TEXTURED || render_request.used_geometry != GEOMETRY_BUFFER_ID::SPRITE)
+		return 0;
+	if (registry.animations.has(entity))
+		return sheets[(GLuint)registry.animations.get(entity).sheet_id];
+	return texture_gl_handles[(GLuint)render_request.used_texture];
+}
+
+// Sprites are collected as long as they come in order and drawn with one instanced call per run of the same
+// texture, entities of other effects are drawn one by one in between.
+void RenderSystem::drawEntities(const std::vector<Entity>& entities, const mat3& projection)
+{
+	for (Entity entity : entities)
+	{
+		GLuint texture = spriteTexture(entity);
+		if (texture == 0) {
+			flushSprites(projection);
+			drawTexturedMesh(entity, projection);
+			continue;
+		}
+
+		SpriteInstance instance;
+		instance.transform = interpolatedTransform(registry.motions.get(entity)).mat;
+		instance.texcoords = vec4(0.f, 0.f, 1.f, 1.f);
+		if (registry.animations.has(entity)) {
+			Animation& animation = registry.animations.get(entity);
+			const Sprite& sprite = m_ftSpriteSheets[(int)animation.sheet_id][animation.sprites[animationFrame(entity, animation)]];
+			instance.texcoords = vec4(sprite.minTexCoords, sprite.maxTexCoords);
+		}
+		instance.color = registry.colors.has(entity) ? (registry.deathTimers.has(entity) ? vec3(1, 0, 0) : registry.colors.get(entity)) : vec3(1);
+		instance.damage = 0.f;
+		if (registry.healths.has(entity)) {
+			const Health& health = registry.healths.get(entity);
+			instance.damage = 1.0f - (health.current_health / health.max_health);
+		}
+
+		if (sprite_batches.empty() || sprite_batches.back().texture != texture)
+			sprite_batches.push_back({ texture, (unsigned int)sprite_instances.size(), 0 });
+		sprite_batches.back().count++;
+		sprite_instances.push_back(instance);
+	}
+	flushSprites(projection);
+}
+
+void RenderSystem::flushSprites(const mat3& projection)
+{
+	if (sprite_instances.empty())
+		return;
+
+	glUseProgram(effects[(GLuint)EFFECT_ASSET_ID::SPRITE_BATCH]);
+	glBindVertexArray(sprite_vao);
+	glUniformMatrix3fv(sprite_projection_loc, 1, GL_FALSE, (float*)&projection);
+	gl_has_errors();
+
+	// Stream the instances, a new store every time so the driver does not wait for the last draws that read the buffer
+	GLsizeiptr size = (GLsizeiptr)(sprite_instances.size() * sizeof(SpriteInstance));
+	sprite_instance_capacity = std::max(sprite_instance_capacity, size);
+	glBindBuffer(GL_ARRAY_BUFFER, sprite_instance_buffer);
+	glBufferData(GL_ARRAY_BUFFER, sprite_instance_capacity, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, sprite_instances.data());
+	gl_has_errors();
+
+	glActiveTexture(GL_TEXTURE0);
+	for (const SpriteBatch& batch : sprite_batches) {
+		glBindTexture(GL_TEXTURE_2D, batch.texture);
+		bindSpriteInstances(batch.first);
+		glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr, batch.count);
+	}
+	gl_has_errors();
+
+	glBindVertexArray(vao);
+	sprite_instances.clear();
+	sprite_batches.clear();
+}
+
+// Points the instance attributes of sprite_vao at the instances of a batch
+void RenderSystem::bindSpriteInstances(unsigned int first)
+{
+	const GLsizei stride = sizeof(SpriteInstance);
+	const size_t offset = first * sizeof(SpriteInstance);
+	// a mat3 attribute is one vec3 per column
+	for (GLuint column = 0; column < 3; column++) {
+		glVertexAttribPointer(2 + column, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(SpriteInstance, transform) + column * sizeof(vec3)));
+	}
+	glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(SpriteInstance, texcoords)));
+	glVertexAttribPointer(6, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(SpriteInstance, color)));
+	glVertexAttribPointer(7, 1, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(SpriteInstance, damage)));
+}
+
 // draw the intermediate texture to the screen, with some distortion to simulate
 // wind
 void RenderSystem::drawToScreen(const mat3& projection)
@@ -478,8 +561,11 @@ void RenderSystem::drawText(const mat3& projection, bool before_post_process)
 
 // Render our game world
 // http://www.opengl-tutorial.org/intermediate-tutorials/tutorial-14-render-to-texture/
-void RenderSystem::draw()
+void RenderSystem::draw(float interpolation)
 {
+	PROFILE_SCOPE("render.draw");
+	this->interpolation = interpolation;
+
 	// Getting size of window
 	int w, h;
 	glfwGetFramebufferSize(window, &w, &h); // Note, this will be 2x the resolution given to glfwCreateWindow on retina displays
@@ -502,50 +588,62 @@ void RenderSystem::draw()
 	mat3 projection_2D = createProjectionMatrix();
 	// Draw all textured meshes that have a position and size component
 	std::vector<Entity> sorted_entities;
-	sorted_entities = registry.renderRequests.entities;
-	std::sort(sorted_entities.begin(), sorted_entities.end(), [this](Entity a, Entity b) {
-		return registry.renderRequests.get(a).used_render_layer < registry.renderRequests.get(b).used_render_layer;
-	});
-
-	for (Entity entity : sorted_entities)
+	std::vector<Entity> menu_entities;
 	{
-		if (
-			!registry.motions.has(entity) || 
-			registry.texts.has(entity)
-			/*registry.renderRequests.get(entity).used_render_layer == RENDER_LAYER::GAME_MENU*/
-		)
-			continue;
-		// Note, its not very efficient to access elements indirectly via the entity
-		// albeit iterating through all Sprites in sequence. A good point to optimize
+		PROFILE_SCOPE("render.sort");
+		// By layer, and within a layer by texture, so that the sprites sharing a texture are drawn in one batch.
+		// Entities of the same texture keep their order.
+		draw_order.clear();
+		for (Entity entity : registry.renderRequests.entities)
+		{
+			if (!registry.motions.has(entity) || registry.texts.has(entity))
+				continue;
+			uint64_t layer = (uint64_t)registry.renderRequests.get(entity).used_render_layer;
+			draw_order.push_back({ (layer << 32) | spriteTexture(entity), entity });
+		}
+		std::stable_sort(draw_order.begin(), draw_order.end(), [](const std::pair<uint64_t, Entity>& a, const std::pair<uint64_t, Entity>& b) {
+			return a.first < b.first;
+		});
+		for (const std::pair<uint64_t, Entity>& entry : draw_order)
+		{
+			sorted_entities.push_back(entry.second);
+			if (registry.renderRequests.get(entry.second).used_render_layer >= RENDER_LAYER::GAME_MENU)
+				menu_entities.push_back(entry.second);
+		}
+	}
 
-		drawTexturedMesh(entity, projection_2D);
+	{
+		PROFILE_SCOPE("render.world");
+		drawEntities(sorted_entities, projection_2D);
 	}
 
-	drawText(projection_2D, true);
+	{
+		PROFILE_SCOPE("render.text");
+		drawText(projection_2D, true);
+	}
 
-	// Truely render to the screen
-	drawToScreen(projection_2D);
+	{
+		// Truely render to the screen
+		PROFILE_SCOPE("render.post_process");
+		drawToScreen(projection_2D);
+	}
 
 	// Renable some features
 	glEnable(GL_BLEND);
 	glEnable(GL_DEPTH_TEST);
 
-	for (Entity entity : sorted_entities) {
-		if (!registry.motions.has(entity) || registry.texts.has(entity))
-			continue;
-
-		if (registry.renderRequests.get(entity).used_render_layer < RENDER_LAYER::GAME_MENU)
-			continue;
-		// Note, its not very efficient to access elements indirectly via the entity
-		// albeit iterating through all Sprites in sequence. A good point to optimize
+	{
+		PROFILE_SCOPE("render.menus");
+		drawEntities(menu_entities, projection_2D);
 
-		drawTexturedMesh(entity, projection_2D);
+		drawText(projection_2D, false);
 	}
 
-	drawText(projection_2D, false);
-
-	// flicker-free display with a double buffer
-	glfwSwapBuffers(window);
+	{
+		// flicker-free display with a double buffer, waits for vsync
+		PROFILE_SCOPE("render.swap_buffers");
+		glfwSwapBuffers(window);
+	}
 	gl_has_errors();
 }
 
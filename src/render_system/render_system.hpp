@@ -3,6 +3,7 @@
 #include <array>
 #include <utility>
 #include <map>
+#include <vector>
 
 #include "common/common.hpp"
 #include "components/components.hpp"
@@ -171,7 +172,8 @@ class RenderSystem {
 		shader_path("coloured"),
 		shader_path("textured"),
 		shader_path("post_process"),
-		shader_path("line")
+		shader_path("line"),
+		shader_path("sprite_batch")
 	};
 
 	std::array<GLuint, font_count> fonts;
@@ -245,8 +247,9 @@ public:
 	// Destroy resources associated to one or all entities created by the system
 	~RenderSystem();
 
-	// Draw all entities
-	void draw();
+	// Draw all entities, interpolation is the fraction of a simulation step that has passed
+	// since the last one, moving entities are drawn between their previous and current position
+	void draw(float interpolation = 1.f);
 
 	// Draw all text entities
 	void drawText(const mat3& projection, bool use_framebuffer);
@@ -267,6 +270,16 @@ private:
 	void drawTexturedMesh(Entity entity, const mat3& projection);
 	void drawToScreen(const mat3& projection);
 
+	// Draws the entities in order, the textured sprites in instanced batches and everything else with drawTexturedMesh
+	void drawEntities(const std::vector<Entity>& entities, const mat3& projection);
+	void flushSprites(const mat3& projection);
+	void bindSpriteInstances(unsigned int first);
+	void initializeSpriteBatch();
+	// texture the entity is drawn with, 0 for entities that are not drawn as batched sprites
+	GLuint spriteTexture(Entity entity);
+	// transform of a motion between its last two physics steps, at the current interpolation factor
+	Transform interpolatedTransform(const Motion& motion) const;
+
 	// Window handle
 	GLFWwindow* window;
 
@@ -277,9 +290,35 @@ private:
 
 	Entity screen_state_entity;
 
+	// Interpolation factor of the frame being drawn, see draw()
+	float interpolation = 1.f;
+
 	GLuint vao;
 	GLuint vbo;
 
+	// Sprite batches, the per sprite data is laid out like the instance attributes of the sprite_batch shader
+	struct SpriteInstance
+	{
+		mat3 transform;
+		vec4 texcoords; // minimum (xy) and maximum (zw) texture coordinates of the sprite
+		vec3 color;
+		float damage;
+	};
+	struct SpriteBatch
+	{
+		GLuint texture;
+		unsigned int first; // first instance of the batch in sprite_instances
+		unsigned int count;
+	};
+	GLuint sprite_vao;
+	GLuint sprite_instance_buffer;
+	GLsizeiptr sprite_instance_capacity = 0; // bytes allocated for the instance buffer
+	GLint sprite_projection_loc;
+	std::vector<SpriteInstance> sprite_instances;
+	std::vector<SpriteBatch> sprite_batches;
+	// (layer and texture, entity) for sorting the entities to draw
+	std::vector<std::pair<uint64_t, Entity>> draw_order;
+
 	// Fonts
 	GLuint m_font_shaderProgram;
 	GLuint m_font_VAO;
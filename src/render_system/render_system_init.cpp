@@ -70,6 +70,7 @@ bool RenderSystem::init(GLFWwindow* window_arg)
 	initializeGlSheets();
 	initializeGlEffects();
 	initializeGlGeometryBuffers();
+	initializeSpriteBatch();
 
 	return true;
 }
@@ -127,6 +128,7 @@ void RenderSystem::initializeGlSheets()
 		GLuint texture;
 		glGenTextures(1, &texture);
 		glBindTexture(GL_TEXTURE_2D, texture);
+		sheets[i] = texture;
 
 		//// generate texture
 		glTexImage2D(
@@ -281,6 +283,33 @@ void RenderSystem::initializeGlGeometryBuffers()
 	bindVBOandIBO(GEOMETRY_BUFFER_ID::SCREEN_TRIANGLE, screen_vertices, screen_indices);
 }
 
+void RenderSystem::initializeSpriteBatch()
+{
+	glGenVertexArrays(1, &sprite_vao);
+	glGenBuffers(1, &sprite_instance_buffer);
+	glBindVertexArray(sprite_vao);
+
+	// The sprite quad, at the attribute locations of the sprite_batch shader
+	glBindBuffer(GL_ARRAY_BUFFER, vertex_buffers[(GLuint)GEOMETRY_BUFFER_ID::SPRITE]);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffers[(GLuint)GEOMETRY_BUFFER_ID::SPRITE]);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void*)0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void*)sizeof(vec3));
+
+	// The instance attributes advance once per sprite, their pointers are set for every batch (see bindSpriteInstances)
+	glBindBuffer(GL_ARRAY_BUFFER, sprite_instance_buffer);
+	for (GLuint location = 2; location <= 7; location++) {
+		glEnableVertexAttribArray(location);
+		glVertexAttribDivisor(location, 1);
+	}
+	gl_has_errors();
+
+	sprite_projection_loc = glGetUniformLocation(effects[(GLuint)EFFECT_ASSET_ID::SPRITE_BATCH], "projection");
+	glBindVertexArray(vao);
+	gl_has_errors();
+}
+
 RenderSystem::~RenderSystem()
 {
 	// font cleanup
@@ -293,6 +322,9 @@ RenderSystem::~RenderSystem()
 	glDeleteBuffers((GLsizei)vertex_buffers.size(), vertex_buffers.data());
 	glDeleteBuffers((GLsizei)index_buffers.size(), index_buffers.data());
 	glDeleteTextures((GLsizei)texture_gl_handles.size(), texture_gl_handles.data());
+	glDeleteTextures((GLsizei)sheets.size(), sheets.data());
+	glDeleteVertexArrays(1, &sprite_vao);
+	glDeleteBuffers(1, &sprite_instance_buffer);
 	glDeleteTextures(1, &off_screen_render_buffer_color);
 	glDeleteRenderbuffers(1, &off_screen_render_buffer_depth);
 	gl_has_errors();
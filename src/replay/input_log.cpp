@@ -0,0 +1,199 @@
+// internal
+#include "replay/input_log.hpp"
+#include "world_system/world_system.hpp"
+
+// stlib
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+const char input_log_magic[4] = { 'V', 'R', 'E', 'C' };
+const uint32_t input_log_version = 2;
+
+// Little endian writers and readers, independent of the byte order of the machine
+static void write_uint(std::ofstream& out, uint64_t value, int bytes)
+{
+	for (int i = 0; i < bytes; i++)
+		out.put((char)((value >> (8 * i)) & 0xFF));
+}
+
+static uint64_t read_uint(std::ifstream& in, int bytes)
+{
+	uint64_t value = 0;
+	for (int i = 0; i < bytes; i++)
+		value |= (uint64_t)(unsigned char)in.get() << (8 * i);
+	return value;
+}
+
+static void write_float(std::ofstream& out, float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	write_uint(out, bits, 4);
+}
+
+static float read_float(std::ifstream& in)
+{
+	uint32_t bits = (uint32_t)read_uint(in, 4);
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+bool InputLog::save(const std::string& path) const
+{
+	std::ofstream out(path, std::ios::binary);
+	if (!out.is_open()) {
+		std::cerr << "could not write input log " << path << std::endl;
+		return false;
+	}
+
+	out.write(input_log_magic, sizeof(input_log_magic));
+	write_uint(out, input_log_version, 4);
+	write_uint(out, seed, 8);
+	write_uint(out, steps, 4);
+	write_uint(out, enemies, 4);
+	write_uint(out, events.size(), 4);
+	for (const InputEvent& event : events) {
+		write_uint(out, event.tick, 4);
+		write_uint(out, (uint8_t)event.type, 1);
+		switch (event.type)
+		{
+		case INPUT_EVENT::KEY:
+			write_uint(out, (uint16_t)event.key, 2);
+			write_uint(out, (uint16_t)event.scancode, 2);
+			write_uint(out, (uint8_t)event.action, 1);
+			write_uint(out, (uint8_t)event.mods, 1);
+			break;
+		case INPUT_EVENT::MOUSE_CLICK:
+			write_uint(out, (uint8_t)event.key, 1);
+			write_uint(out, (uint8_t)event.action, 1);
+			write_uint(out, (uint8_t)event.mods, 1);
+			break;
+		case INPUT_EVENT::MOUSE_MOVE:
+		case INPUT_EVENT::SCROLL:
+			write_float(out, event.position.x);
+			write_float(out, event.position.y);
+			break;
+		}
+	}
+	return out.good();
+}
+
+bool InputLog::load(const std::string& path)
+{
+	std::ifstream in(path, std::ios::binary);
+	char magic[sizeof(input_log_magic)];
+	if (!in.is_open() || !in.read(magic, sizeof(magic)) || std::memcmp(magic, input_log_magic, sizeof(magic)) != 0) {
+		std::cerr << "could not read input log " << path << std::endl;
+		return false;
+	}
+	if (read_uint(in, 4) != input_log_version) {
+		std::cerr << "unsupported input log version in " << path << std::endl;
+		return false;
+	}
+
+	seed = read_uint(in, 8);
+	steps = (uint32_t)read_uint(in, 4);
+	enemies = (uint32_t)read_uint(in, 4);
+	uint32_t count = (uint32_t)read_uint(in, 4);
+	events.clear();
+	events.reserve(count);
+	for (uint32_t i = 0; i < count && in.good(); i++) {
+		InputEvent event;
+		event.tick = (uint32_t)read_uint(in, 4);
+		event.type = (INPUT_EVENT)read_uint(in, 1);
+		switch (event.type)
+		{
+		case INPUT_EVENT::KEY:
+			event.key = (int16_t)read_uint(in, 2);
+			event.scancode = (int16_t)read_uint(in, 2);
+			event.action = (int)read_uint(in, 1);
+			event.mods = (int)read_uint(in, 1);
+			break;
+		case INPUT_EVENT::MOUSE_CLICK:
+			event.key = (int)read_uint(in, 1);
+			event.action = (int)read_uint(in, 1);
+			event.mods = (int)read_uint(in, 1);
+			break;
+		case INPUT_EVENT::MOUSE_MOVE:
+		case INPUT_EVENT::SCROLL:
+			event.position.x = read_float(in);
+			event.position.y = read_float(in);
+			break;
+		default:
+			std::cerr << "corrupt input log " << path << std::endl;
+			return false;
+		}
+		events.push_back(event);
+	}
+	if (!in.good()) {
+		std::cerr << "truncated input log " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void InputRecorder::key(int key, int scancode, int action, int mods)
+{
+	InputEvent event;
+	event.tick = tick;
+	event.type = INPUT_EVENT::KEY;
+	event.key = key;
+	event.scancode = scancode;
+	event.action = action;
+	event.mods = mods;
+	log.events.push_back(event);
+}
+
+void InputRecorder::mouse_move(vec2 position)
+{
+	InputEvent event;
+	event.tick = tick;
+	event.type = INPUT_EVENT::MOUSE_MOVE;
+	event.position = position;
+	log.events.push_back(event);
+}
+
+void InputRecorder::mouse_click(int button, int action, int mods)
+{
+	InputEvent event;
+	event.tick = tick;
+	event.type = INPUT_EVENT::MOUSE_CLICK;
+	event.key = button;
+	event.action = action;
+	event.mods = mods;
+	log.events.push_back(event);
+}
+
+void InputRecorder::scroll(double x_offset, double y_offset)
+{
+	InputEvent event;
+	event.tick = tick;
+	event.type = INPUT_EVENT::SCROLL;
+	event.position = { (float)x_offset, (float)y_offset };
+	log.events.push_back(event);
+}
+
+void InputReplay::feed(WorldSystem& world)
+{
+	while (next_event < log.events.size() && log.events[next_event].tick <= tick) {
+		const InputEvent& event = log.events[next_event++];
+		switch (event.type)
+		{
+		case INPUT_EVENT::KEY:
+			world.on_key(event.key, event.scancode, event.action, event.mods);
+			break;
+		case INPUT_EVENT::MOUSE_MOVE:
+			world.on_mouse_move(event.position);
+			break;
+		case INPUT_EVENT::MOUSE_CLICK:
+			world.on_mouse_click(event.key, event.action, event.mods);
+			break;
+		case INPUT_EVENT::SCROLL:
+			world.on_scroll(event.position.x, event.position.y);
+			break;
+		}
+	}
+	tick++;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+// stlib
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/common.hpp"
+
+class WorldSystem;
+
+// Input recording and replay.
+// Every input event that reaches WorldSystem is stored with the simulation step it was handled before.
+// Together with the session seed (see RandomService) that is all a session depends on,
+// so feeding the events back at the same steps simulates the same game again.
+
+enum class INPUT_EVENT : uint8_t
+{
+	KEY = 0,
+	MOUSE_MOVE = 1,
+	MOUSE_CLICK = 2,
+	SCROLL = 3
+};
+
+struct InputEvent
+{
+	uint32_t tick = 0;
+	INPUT_EVENT type = INPUT_EVENT::KEY;
+	int key = 0;		// key or mouse button
+	int scancode = 0;
+	int action = 0;
+	int mods = 0;
+	vec2 position = { 0, 0 }; // mouse position or scroll offset
+};
+
+// Binary log file:
+//   header: "VREC", uint32 version, uint64 session seed, uint32 steps, uint32 enemies, uint32 event count
+//   event:  uint32 tick, uint8 type, then
+//           KEY:         int16 key, int16 scancode, uint8 action, uint8 mods
+//           MOUSE_MOVE:  float x, float y
+//           MOUSE_CLICK: uint8 button, uint8 action, uint8 mods
+//           SCROLL:      float x, float y
+// Multi-byte values are little endian
+struct InputLog
+{
+	uint64_t seed = 0;
+	uint32_t steps = 0; // length of the recorded session
+	uint32_t enemies = 0; // enemies the headless runner keeps in the room (--enemies), 0 for a normal game
+	std::vector<InputEvent> events;
+
+	bool save(const std::string& path) const;
+	bool load(const std::string& path);
+};
+
+// Collects the events of a session, WorldSystem reports to it when its recorder is set
+class InputRecorder
+{
+	InputLog log;
+	uint32_t tick = 0;
+
+public:
+	InputRecorder(uint64_t seed) { log.seed = seed; }
+	void set_enemies(uint32_t count) { log.enemies = count; }
+
+	void key(int key, int scancode, int action, int mods);
+	void mouse_move(vec2 position);
+	void mouse_click(int button, int action, int mods);
+	void scroll(double x_offset, double y_offset);
+
+	// Called after every simulation step
+	void next_tick() { log.steps = ++tick; }
+
+	bool save(const std::string& path) const { return log.save(path); }
+};
+
+// Feeds a recorded session back into the world, one simulation step at a time
+class InputReplay
+{
+	InputLog log;
+	uint32_t tick = 0;
+	size_t next_event = 0;
+
+public:
+	bool load(const std::string& path) { return log.load(path); }
+	uint64_t get_seed() const { return log.seed; }
+	uint32_t get_enemies() const { return log.enemies; }
+
+	// Number of recorded steps
+	uint32_t length() const { return log.steps; }
+	bool finished() const { return tick >= length(); }
+
+	// Delivers the events of the current step, call before every simulation step
+	void feed(WorldSystem& world);
+};
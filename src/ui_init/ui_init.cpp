@@ -20,6 +20,7 @@ Entity createTextButton(
 
 	// Set the position of the button
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = position;
 	motion.scale = size;
 
@@ -73,6 +74,7 @@ Entity createButton(
 	Button& button = registry.buttons.emplace(entity);
 
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = position;
 	motion.scale = size;
 
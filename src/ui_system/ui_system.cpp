@@ -4,6 +4,7 @@
 #include "ecs_registry/ecs_registry.hpp"
 #include "audio_manager/audio_manager.hpp"
 #include "weapon_system/weapon_system.hpp"
+#include "profiler/profiler.hpp"
 
 #include <iomanip>
 #include <iostream>
@@ -31,6 +32,7 @@ void UISystem::createMap(Level& level) {
 	auto entity = Entity();
 
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = { top_left_corner_x, top_left_corner_y };
 	motion.scale = vec2({ box_width, box_height });
 
@@ -54,6 +56,7 @@ void UISystem::createMap(Level& level) {
 				Room& room = registry.rooms.get(level.rooms[room_coords]);
 				auto entity = Entity();
 				Motion& motion = registry.motions.emplace(entity);
+				set_collision_layer(motion, COLLISION_LAYER::UI);
 				motion.position = { top_left_corner_x + (x * box_width), top_left_corner_y - (y * box_height) };
 				motion.scale = vec2({ box_width, box_height });
 
@@ -147,6 +150,7 @@ void UISystem::updateMap(Level& level) {
 				auto entity = Entity();
 
 				Motion& motion = registry.motions.emplace(entity);
+				set_collision_layer(motion, COLLISION_LAYER::UI);
 				motion.position = { top_left_corner_x + (x * box_width), top_left_corner_y - (y * box_height) };
 				motion.scale = vec2({ box_width, box_height });
 
@@ -559,7 +563,7 @@ void UISystem::init(RenderSystem* renderer_arg, Health& player_health, Shield& p
 	createFirstTutorialRoomText();
 }
 
-void UISystem::update(Health& player_health, Shield& player_shield, Player& player, int score, float multiplier, int deltaScore, bool showFPS, Level& level)
+void UISystem::update(Health& player_health, Shield& player_shield, Player& player, int score, float multiplier, int deltaScore, bool showFPS, bool showProfiler, Level& level)
 {
 	updateMap(level);
 	updatePlayerStatus(player_health, player_shield);
@@ -572,9 +576,8 @@ void UISystem::update(Health& player_health, Shield& player_shield, Player& play
 			fps_text = createText(renderer, "", { fps_x, fps_y }, 0.8f, { 0.0f, 1.0f, 1.0f }, TextAlignment::LEFT);
 			showingFPS = true;
 		}
-		// FPS
+		// FPS, measured per rendered frame by fpsCalculate() in the main loop
 		float startTicks = SDL_GetTicks();
-		fpsCalculate();
 		static int frameCounter = 0;
 		frameCounter++;
 		// update fps every 50 frames 
@@ -591,6 +594,65 @@ void UISystem::update(Health& player_health, Shield& player_shield, Player& play
 		}
 	}
 
+	if (showProfiler) {
+		updateProfilerOverlay();
+	}
+	else {
+		removeProfilerOverlay();
+	}
+}
+
+float profiler_x = 1460.0f, profiler_y = 70.0f, profiler_line_height = 22.0f;
+void UISystem::updateProfilerOverlay()
+{
+	// a header, one line for the whole frame and one per section
+	int lines = profiler.section_count() + 2;
+	bool recreate = (int)profiler_texts.size() != lines;
+	for (Entity text : profiler_texts) {
+		recreate = recreate || !registry.texts.has(text);
+	}
+	if (recreate) {
+		removeProfilerOverlay();
+		for (int i = 0; i < lines; i++) {
+			profiler_texts.push_back(createText(renderer, "", { profiler_x, profiler_y + i * profiler_line_height }, 0.45f, COLOR_WHITE, TextAlignment::LEFT));
+		}
+	}
+
+	// the statistics cover the last few seconds, refreshing them a few times per second is enough
+	static int frameCounter = 0;
+	if (!recreate && ++frameCounter < 30) {
+		return;
+	}
+	frameCounter = 0;
+
+	// a frame over this takes the game below 60 fps
+	const float frame_budget_ms = 1000.f / 60.f;
+	char line[128];
+	registry.texts.get(profiler_texts[0]).content = "ms per frame                 min     avg     p99";
+
+	Profiler::Stats frame = profiler.frame_stats();
+	snprintf(line, sizeof(line), "%-26s %7.2f %7.2f %7.2f", "frame", frame.min_ms, frame.avg_ms, frame.p99_ms);
+	Text& frame_text = registry.texts.get(profiler_texts[1]);
+	frame_text.content = line;
+	frame_text.color = frame.p99_ms > frame_budget_ms ? COLOR_RED : COLOR_WHITE;
+
+	for (int i = 0; i < profiler.section_count(); i++) {
+		Profiler::Stats stats = profiler.section_stats(i);
+		std::string name = std::string(2 * profiler.section_depth(i), ' ') + profiler.section_name(i);
+		snprintf(line, sizeof(line), "%-26s %7.2f %7.2f %7.2f", name.c_str(), stats.min_ms, stats.avg_ms, stats.p99_ms);
+		Text& text = registry.texts.get(profiler_texts[i + 2]);
+		text.content = line;
+		// this section alone takes the frame over budget
+		text.color = stats.p99_ms > frame_budget_ms ? COLOR_RED : COLOR_WHITE;
+	}
+}
+
+void UISystem::removeProfilerOverlay()
+{
+	for (Entity text : profiler_texts) {
+		registry.remove_all_components_of(text);
+	}
+	profiler_texts.clear();
 }
 
 void UISystem::reinit(Health& player_health, Shield& player_shield, Player& player, int score, float multiplier, int deltaScore, Level& level) {
@@ -7,8 +7,6 @@
 class UISystem
 {
 private:
-	void fpsCalculate();
-
 	RenderSystem* renderer;
 
 	// Health
@@ -40,6 +38,9 @@ private:
 	float frameTime;
 	bool showingFPS;
 
+	// Profiler overlay, one line per profiled section
+	std::vector<Entity> profiler_texts;
+
 	// Map
 	std::pair<int, int> current_room;
 	std::vector<Entity> drawn_rooms;
@@ -56,8 +57,13 @@ private:
 	void createFirstTutorialRoomText();
 	void createSecondTutorialRoomText();
 	void updateWeaponMenu(Player& player);
+	void updateProfilerOverlay();
+	void removeProfilerOverlay();
 public:
+	// Measures the frame rate, called once per rendered frame
+	void fpsCalculate();
+
 	void init(RenderSystem* renderer, Health& player_health, Shield& player_shield, Player& player, int score, float multiplier, Level& current_level);
 	void reinit(Health& player_health, Shield& player_shield, Player& player, int score, float multiplier, int deltaScore, Level& level);
-	void update(Health& player_health, Shield& player_shield, Player& player, int score, float multiplier, int deltaScore, bool showFPS, Level& current_level);
+	void update(Health& player_health, Shield& player_shield, Player& player, int score, float multiplier, int deltaScore, bool showFPS, bool showProfiler, Level& current_level);
 };
\ No newline at end of file
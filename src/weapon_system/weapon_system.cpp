@@ -8,7 +8,8 @@ void WeaponSystem::step(float elapsed_ms, RenderSystem* renderer, Entity& player
 	step_weapon_timers(elapsed_ms);
 
 	Player& p = registry.players.get(player);
-	Motion& p_m = registry.motions.get(player);
+	// copy, the projectiles created below can move the player motion
+	Motion p_m = registry.motions.get(player);
 	
 	// Handle reloading
 	if (init_reload) {
@@ -48,10 +49,10 @@ void WeaponSystem::step(float elapsed_ms, RenderSystem* renderer, Entity& player
 		if (p.fire_rate_timer_ms <= 0) {
 			createMuzzleFlash(renderer, player);
 			p.fire_rate_timer_ms = weapon_stats[p.weapon_type].fire_rate;
-			float rng_gen = uniform_dist(rng);
+			float rng_gen = random_service.uniform(RANDOM_STREAM::COMBAT);
 			if (p.accuracy_boost) {
 				// Reduce the spread of the bullets
-				rng_gen = uniform_dist(rng) * 0.5f;
+				rng_gen = random_service.uniform(RANDOM_STREAM::COMBAT) * 0.5f;
 			}
 			switch (p.weapon_type)
 			{
@@ -84,7 +85,7 @@ void WeaponSystem::step(float elapsed_ms, RenderSystem* renderer, Entity& player
 
 			case WeaponType::ENERGY_HALO:
 				for (int i = 0; i < 16; i++) {
-					createEnergyHaloProjectile(renderer, p_m.position, p_m.look_angle - M_PI / 2, uniform_dist(rng), p.fire_length_ms, i, player);
+					createEnergyHaloProjectile(renderer, p_m.position, p_m.look_angle - M_PI / 2, random_service.uniform(RANDOM_STREAM::COMBAT), p.fire_length_ms, i, player);
 				}
 				play_sound(energy_halo_sound);
 				break;
@@ -110,19 +111,18 @@ void WeaponSystem::step(float elapsed_ms, RenderSystem* renderer, Entity& player
 
 void WeaponSystem::step_projectile_lifetime(float elapsed_ms) 
 {
-	for (auto e : registry.projectiles.entities) {
-		registry.projectiles.get(e).lifetime -= elapsed_ms;
-		if (registry.projectiles.get(e).lifetime <= 0.0f) {
-			registry.remove_all_components_of(e);
+	registry.projectile_rows.each([elapsed_ms](Entity e, Projectile& projectile, Motion&) {
+		projectile.lifetime -= elapsed_ms;
+		if (projectile.lifetime <= 0.0f) {
+			registry.commands.destroy(e);
 		}
-	}
+	});
 }
 
 void WeaponSystem::step_projectile_movement(float elapsed_ms)
 {
-	for (auto e : registry.projectiles.entities) {
-		if (registry.projectiles.get(e).weapon_type == WeaponType::ENERGY_HALO) {
-			Motion& projectile_m = registry.motions.get(e);
+	registry.projectile_rows.each([elapsed_ms](Entity, Projectile& projectile, Motion& projectile_m) {
+		if (projectile.weapon_type == WeaponType::ENERGY_HALO) {
 			Motion& player_m = registry.motions.get(registry.players.entities[0]);
 
 			// Calculate the new position of the projectile around the player
@@ -141,7 +141,7 @@ void WeaponSystem::step_projectile_movement(float elapsed_ms)
 			float rotationSpeed = 0.002f; // Adjust this rotation speed as needed
 			projectile_m.look_angle += rotationSpeed * elapsed_ms;
 		}
-	}
+	});
 }
 
 void WeaponSystem::step_weapon_timers(float elapsed_ms) 
@@ -151,8 +151,9 @@ void WeaponSystem::step_weapon_timers(float elapsed_ms)
 		OnFireTimer& timer = registry.onFireTimers.get(entity);
 		timer.counter_ms -= elapsed_ms;
 
-		// move the fire
-		registry.motions.get(timer.fire).position = registry.motions.get(entity).position;
+		// move the fire, unless it was already destroyed (e.g. on room exit)
+		if (registry.motions.has(timer.fire))
+			registry.motions.get(timer.fire).position = registry.motions.get(entity).position;
 		// registry.motions.get(timer.fire).look_angle = registry.motions.get(entity).look_angle;
 
 		// deal dot damage
@@ -1,8 +1,13 @@
 #include "world_generator/world_generator.hpp"
 #include <ctime>
-#include <random>
 
 #include "ecs_registry/ecs_registry.hpp"
+#include "random_service/random_service.hpp"
+
+// number between 2..12 (don't spawn obstacles too close to where we start)
+static float random_position() {
+	return random_service.uniform(RANDOM_STREAM::WORLDGEN, 2, 12);
+}
 
 static bool shouldAvoidPosition(vec2 position) {
 	if (position.x >= 6 && position.x <= 8 || position.y >= 6 && position.y <= 8) return true;
@@ -14,15 +19,9 @@ void WorldGenerator::populateRoom(Room& room)
 	// space is effectively 15x15 since 480/32 = 30 
 	room.is_cleared = false;
 	
-	std::default_random_engine rng = std::default_random_engine(std::random_device()());
-
-	// number between 2..12 (don't spawn obstacles too close to where we start)
-	std::uniform_real_distribution<float> position_uniform_dist(2,12);
-
 	// randomize number of enemies/obstacles per room
-	std::uniform_real_distribution<float> num_positions_uniform_dist(2, 4);
-	room.obstacle_count = num_positions_uniform_dist(rng);
-	room.enemy_count = num_positions_uniform_dist(rng);
+	room.obstacle_count = random_service.uniform(RANDOM_STREAM::WORLDGEN, 2, 4);
+	room.enemy_count = random_service.uniform(RANDOM_STREAM::WORLDGEN, 2, 4);
 
 
 	// Assume only 1 level - add 1 enemy / obstacle for each room the enemy has cleared
@@ -37,8 +36,8 @@ void WorldGenerator::populateRoom(Room& room)
 	int cur_obstacles_count = 0;
 
 	while (room.obstacle_positions.size() < room.obstacle_count) {
-		int rand_x = std::rint(position_uniform_dist(rng));
-		int rand_y = std::rint(position_uniform_dist(rng));
+		int rand_x = std::rint(random_position());
+		int rand_y = std::rint(random_position());
 		vec2 position = vec2(rand_x, rand_y);
 		if (!shouldAvoidPosition(position)) {
 			room.obstacle_positions.insert(vec2(rand_x, rand_y));
@@ -47,8 +46,8 @@ void WorldGenerator::populateRoom(Room& room)
 	}
 
 	while (room.enemy_positions.size() < room.enemy_count) {
-		int rand_x = std::rint(position_uniform_dist(rng));
-		int rand_y = std::rint(position_uniform_dist(rng));
+		int rand_x = std::rint(random_position());
+		int rand_y = std::rint(random_position());
 		vec2 position = vec2(rand_x, rand_y);
 		// if something is not already in this position and it's not too close to the middle, add it
 		if (!room.all_positions.count(position) == 1 && !shouldAvoidPosition(position)) {
@@ -65,11 +64,6 @@ void WorldGenerator::populateFirstRoom(Room& room)
 	// space is effectively 15x15 since 480/32 = 30 
 	room.is_cleared = false;
 
-	std::default_random_engine rng = std::default_random_engine(std::random_device()());
-
-	// number between 2..12 (don't spawn obstacles too close to where we start)
-	std::uniform_real_distribution<float> position_uniform_dist(2, 12);
-
 	// randomize number of enemies/obstacles per room
 	room.obstacle_count = 3;
 	room.enemy_count = 1;
@@ -81,8 +75,8 @@ void WorldGenerator::populateFirstRoom(Room& room)
 	int cur_obstacles_count = 0;
 
 	while (room.obstacle_positions.size() < room.obstacle_count) {
-		int rand_x = std::rint(position_uniform_dist(rng));
-		int rand_y = std::rint(position_uniform_dist(rng));
+		int rand_x = std::rint(random_position());
+		int rand_y = std::rint(random_position());
 		vec2 position = vec2(rand_x, rand_y);
 		if (!shouldAvoidPosition(position)) {
 			room.obstacle_positions.insert(vec2(rand_x, rand_y));
@@ -91,8 +85,8 @@ void WorldGenerator::populateFirstRoom(Room& room)
 	}
 
 	while (room.enemy_positions.size() < room.enemy_count) {
-		int rand_x = std::rint(position_uniform_dist(rng));
-		int rand_y = std::rint(position_uniform_dist(rng));
+		int rand_x = std::rint(random_position());
+		int rand_y = std::rint(random_position());
 		vec2 position = vec2(rand_x, rand_y);
 		// if something is not already in this position and it's not too close to the middle, add it
 		if (!room.all_positions.count(position) == 1 && !shouldAvoidPosition(position)) {
@@ -174,15 +168,11 @@ void WorldGenerator::generateNewRoom(Room& room, Level& level)
 	Room* current_room_pointer = &room;
 
 
-	std::default_random_engine rng = std::default_random_engine(std::random_device()());
-
 	// number between 0..1 - 50/50 if a door will be there.
-	std::uniform_real_distribution<float> room_uniform_dist(0, 1);
-
-	int top_room_rng = std::rint(room_uniform_dist(rng));
-	int bot_room_rng = std::rint(room_uniform_dist(rng));
-	int left_room_rng = std::rint(room_uniform_dist(rng));
-	int right_room_rng = std::rint(room_uniform_dist(rng));
+	int top_room_rng = std::rint(random_service.uniform(RANDOM_STREAM::WORLDGEN));
+	int bot_room_rng = std::rint(random_service.uniform(RANDOM_STREAM::WORLDGEN));
+	int left_room_rng = std::rint(random_service.uniform(RANDOM_STREAM::WORLDGEN));
+	int right_room_rng = std::rint(random_service.uniform(RANDOM_STREAM::WORLDGEN));
 
 	if (level.rooms.count(left_room_coords) > 0 && registry.rooms.get(level.rooms[left_room_coords]).is_visited)
 	{
@@ -3,10 +3,47 @@
 #include "weapon_system/weapon_system.hpp"
 #include "world_generator/world_generator.hpp"
 #include "world_system/world_system.hpp"
+#include "random_service/random_service.hpp"
 
 #include <cmath>
-#include <random>
-#include <glm/gtc/random.hpp>
+
+void set_collision_layer(Motion& motion, unsigned int layer)
+{
+	using namespace COLLISION_LAYER;
+
+	// Collision matrix, only the pairs that WorldSystem::handle_collisions reacts to.
+	// Every mask keeps DEFAULT so entities without a layer are still checked against everything.
+	motion.collision_layer = layer;
+	switch (layer)
+	{
+	case PLAYER:
+		motion.collision_mask = DEFAULT | ENEMY | ENEMY_PROJECTILE | OBSTACLE | PICKUP;
+		break;
+	case ENEMY:
+		// enemies are obstacles too, they stop enemy projectiles and bounce off each other and pickups
+		motion.collision_mask = DEFAULT | PLAYER | ENEMY | PLAYER_PROJECTILE | ENEMY_PROJECTILE | OBSTACLE | PICKUP;
+		break;
+	case PLAYER_PROJECTILE:
+		// energy halo projectiles destroy enemy projectiles
+		motion.collision_mask = DEFAULT | ENEMY | ENEMY_PROJECTILE | OBSTACLE;
+		break;
+	case ENEMY_PROJECTILE:
+		motion.collision_mask = DEFAULT | PLAYER | ENEMY | PLAYER_PROJECTILE | OBSTACLE;
+		break;
+	case OBSTACLE:
+		motion.collision_mask = DEFAULT | PLAYER | ENEMY | PLAYER_PROJECTILE | ENEMY_PROJECTILE;
+		break;
+	case PICKUP:
+		motion.collision_mask = DEFAULT | PLAYER | ENEMY;
+		break;
+	case UI:
+		motion.collision_mask = NONE;
+		break;
+	default:
+		motion.collision_mask = ALL;
+		break;
+	}
+}
 
 
 Entity createPlayer(RenderSystem *renderer, vec2 pos)
@@ -18,6 +55,7 @@ Entity createPlayer(RenderSystem *renderer, vec2 pos)
 
 	// Setting initial motion values
 	Motion &motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::PLAYER);
 	motion.position = pos;
 	motion.complex = true;
 	motion.acceleration_rate = 50.f;
@@ -61,10 +99,12 @@ Entity createEnemy(RenderSystem *renderer, vec2 position, float health_points, A
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::ENEMY);
 	AI& ai = registry.ais.emplace(entity);
 	ai.type = aiType; // based on passed parameter
 	ai.state = AI::AIState::ACTIVE;
 	ai.frequency = 5;
+	ai.waypoint = position; // stay until the first think cycle
 	motion.position = position;
 	motion.complex = false;
 	motion.scale = vec2({ ENEMY_BB_WIDTH, ENEMY_BB_HEIGHT });
@@ -199,6 +239,7 @@ Entity createBoss(RenderSystem* renderer, vec2 position, float health_points, Bo
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::ENEMY);
 	BossAI& boss = registry.bosses.emplace(entity);
 	boss.state = BossAI::BossState::DEFENSIVE;
 	motion.position = position;
@@ -281,6 +322,7 @@ Entity createObstacle(RenderSystem *renderer, vec2 position)
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::OBSTACLE);
 	motion.position = position;
 	motion.complex = false;
 	motion.scale = vec2({ OBSTACLE_BB_WIDTH, OBSTACLE_BB_HEIGHT });
@@ -332,11 +374,13 @@ Entity createProjectile(RenderSystem* render, vec2 position, float angle, float
 
 	// Setting initial motion values
 	Motion &motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::PLAYER_PROJECTILE);
 	Projectile& projectile = registry.projectiles.emplace(entity);
 	motion.position = position;
 	motion.look_angle = angle + M_PI / 4;
 	motion.scale = vec2({BULLET_BB_WIDTH, BULLET_BB_HEIGHT});
 	motion.velocity = vec2({1000.0f * cos(angle), 1000.0f * sin(angle)});
+	motion.fast = true;
 	
 	// Set the source of the projectile
 	registry.projectiles.get(entity).source = source;
@@ -366,6 +410,7 @@ Entity createEnemyProjectile(RenderSystem* render, vec2 position, float angle, E
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::ENEMY_PROJECTILE);
 	Projectile& projectile = registry.projectiles.emplace(entity);
 	motion.position = position;
 	motion.look_angle = angle + M_PI / 4;
@@ -401,11 +446,13 @@ Entity createSniperProjectile(RenderSystem* render, vec2 position, float angle,
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::PLAYER_PROJECTILE);
 	Projectile& projectile = registry.projectiles.emplace(entity);
 	motion.position = position;
 	motion.look_angle = angle + M_PI ;
 	motion.scale = vec2({ 48.f, 48.f });
 	motion.velocity = vec2({ 2000.0f * cos(angle), 2000.0f * sin(angle) });
+	motion.fast = true;
 
 	// Set the source of the projectile
 	registry.projectiles.get(entity).source = source;
@@ -443,6 +490,7 @@ Entity createEnemySniperProjectile(RenderSystem* render, vec2 position, float an
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::ENEMY_PROJECTILE);
 	Projectile& projectile = registry.projectiles.emplace(entity);
 	motion.position = position;
 	motion.look_angle = angle + M_PI;
@@ -494,11 +542,14 @@ Entity createShotgunProjectile(RenderSystem* render, vec2 position, float angle,
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	// shotgun enemies fire through this overload as well
+	set_collision_layer(motion, registry.players.has(source) ? COLLISION_LAYER::PLAYER_PROJECTILE : COLLISION_LAYER::ENEMY_PROJECTILE);
 	Projectile& projectile = registry.projectiles.emplace(entity);
 	motion.position = position;
 	motion.look_angle = coneAngle;
 	motion.scale = vec2({ BULLET_BB_WIDTH * 0.8, BULLET_BB_HEIGHT * 0.8 });
 	motion.velocity = vec2({ 1000.0f * cos(coneAngle), 1000.0f * sin(coneAngle) });
+	motion.fast = true;
 	
 	// Set the source of the projectile
 	registry.projectiles.get(entity).source = source;
@@ -525,11 +576,13 @@ Entity createShotgunProjectile(RenderSystem* render, vec2 position, float angle,
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::ENEMY_PROJECTILE);
 	Projectile& projectile = registry.projectiles.emplace(entity);
 	motion.position = position;
 	motion.look_angle = angle;
 	motion.scale = vec2({ BULLET_BB_WIDTH * 0.8, BULLET_BB_HEIGHT * 0.8 });
 	motion.velocity = vec2({ 1000.0f * cos(angle), 1000.0f * sin(angle) });
+	motion.fast = true;
 
 	// Set the source of the projectile
 	registry.projectiles.get(entity).source = source;
@@ -563,6 +616,7 @@ Entity createRocketProjectile(RenderSystem* render, vec2 position, float angle,
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::PLAYER_PROJECTILE);
 	Projectile& projectile = registry.projectiles.emplace(entity);
 	motion.position = position;
 	motion.look_angle = angle;
@@ -605,6 +659,7 @@ Entity createEnemyRocketProjectile(RenderSystem* render, vec2 position, float an
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::ENEMY_PROJECTILE);
 	Projectile& projectile = registry.projectiles.emplace(entity);
 	motion.position = position;
 	motion.look_angle = angle;
@@ -654,10 +709,11 @@ Entity createFlamethrowerProjectile(RenderSystem* render, vec2 position, float a
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::PLAYER_PROJECTILE);
 	Projectile& projectile = registry.projectiles.emplace(entity);
 	motion.position = position;
 	motion.look_angle = angle + M_PI / 4;
-	motion.scale = vec2({ 32.f * glm::linearRand(0.8f, 1.2f), 32.f * glm::linearRand(0.8f, 1.2f) });
+	motion.scale = vec2({ 32.f * random_service.uniform(RANDOM_STREAM::COMBAT, 0.8f, 1.2f), 32.f * random_service.uniform(RANDOM_STREAM::COMBAT, 0.8f, 1.2f) });
 	motion.velocity = vec2({ 600.0f * cos(angle), 600.0f * sin(angle) });
 
 	// Set the source of the projectile
@@ -702,6 +758,7 @@ Entity createEnergyHaloProjectile(RenderSystem* render, vec2 position, float ang
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::PLAYER_PROJECTILE);
 	Projectile& projectile = registry.projectiles.emplace(entity);
 	motion.position = position;
 	motion.look_angle = shoot_angle;
@@ -744,6 +801,7 @@ Entity createEnemyFlamethrowerProjectile(RenderSystem* render, vec2 position, fl
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::ENEMY_PROJECTILE);
 	Projectile& projectile = registry.projectiles.emplace(entity);
 	motion.position = position;
 	motion.look_angle = angle + M_PI / 4;
@@ -785,6 +843,7 @@ Entity createStartScreen(RenderSystem* renderer) {
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = { window_width_px / 2, window_height_px / 2 };
 	motion.scale = vec2({ window_width_px, window_height_px });
 
@@ -804,6 +863,7 @@ Entity createDeathScreen(RenderSystem* renderer) {
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = { window_width_px / 2, window_height_px / 2 };
 	motion.scale = vec2({ window_width_px, window_height_px });
 
@@ -822,6 +882,7 @@ Entity createWinScreen(RenderSystem* renderer) {
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = { window_width_px / 2, window_height_px / 2 };
 	motion.scale = vec2({ window_width_px, window_height_px });
 
@@ -856,6 +917,7 @@ void createWalls(RenderSystem* render, Room& room)
 	bool cleared_room = room.enemy_count == 0;
 	// top wall
 	Motion& top_motion = registry.motions.emplace(topWall);
+	set_collision_layer(top_motion, COLLISION_LAYER::OBSTACLE);
 	top_motion.position = vec2({ x_mid, y_min });
 	top_motion.scale = vec2({ HORIZONTAL_WALL_BB_WIDTH, HORIZONTAL_WALL_BB_HEIGHT });
 
@@ -868,6 +930,7 @@ void createWalls(RenderSystem* render, Room& room)
 			top_wall_texture = TEXTURE_ASSET_ID::TOP_LEVEL1_FULL_WALL_OPEN_DOOR;
 			auto top_door = Entity();
 			Motion& top_door_motion = registry.motions.emplace(top_door);
+			set_collision_layer(top_door_motion, COLLISION_LAYER::OBSTACLE);
 			top_door_motion.position = { x_mid, y_min };
 			top_door_motion.scale = { 64,64 };
 			Obstacle& top_door_obstacle = registry.obstacles.emplace(top_door);
@@ -890,6 +953,7 @@ void createWalls(RenderSystem* render, Room& room)
 
 	// bottom wall
 	Motion& bottom_motion = registry.motions.emplace(bottomWall);
+	set_collision_layer(bottom_motion, COLLISION_LAYER::OBSTACLE);
 	bottom_motion.position = vec2({ x_mid, y_max });
 	bottom_motion.scale = vec2({ HORIZONTAL_WALL_BB_WIDTH, HORIZONTAL_WALL_BB_HEIGHT });
 
@@ -901,6 +965,7 @@ void createWalls(RenderSystem* render, Room& room)
 			bottom_wall_texture = TEXTURE_ASSET_ID::BOTTOM_LEVEL1_FULL_WALL_OPEN_DOOR;
 			auto bottom_door = Entity();
 			Motion& bottom_door_motion = registry.motions.emplace(bottom_door);
+			set_collision_layer(bottom_door_motion, COLLISION_LAYER::OBSTACLE);
 			bottom_door_motion.position = { x_mid, y_max };
 			bottom_door_motion.scale = { 64,64 };
 			Obstacle& bottom_door_obstacle = registry.obstacles.emplace(bottom_door);
@@ -925,6 +990,7 @@ void createWalls(RenderSystem* render, Room& room)
 	// player can pass through the door if it exists
 	// left wall
 	Motion& left_motion = registry.motions.emplace(leftWall);
+	set_collision_layer(left_motion, COLLISION_LAYER::OBSTACLE);
 	left_motion.position = vec2({ x_min, y_mid });
 	left_motion.scale = vec2({ VERTICAL_WALL_BB_HEIGHT , VERTICAL_WALL_BB_WIDTH });
 
@@ -937,6 +1003,7 @@ void createWalls(RenderSystem* render, Room& room)
 			left_wall_texture = TEXTURE_ASSET_ID::LEFT_LEVEL1_FULL_WALL_OPEN_DOOR;
 			auto left_door = Entity();
 			Motion& left_door_motion = registry.motions.emplace(left_door);
+			set_collision_layer(left_door_motion, COLLISION_LAYER::OBSTACLE);
 			left_door_motion.position = { x_min, y_mid };
 			left_door_motion.scale = { 64,64 };
 			Obstacle& left_door_obstacle = registry.obstacles.emplace(left_door);
@@ -959,6 +1026,7 @@ void createWalls(RenderSystem* render, Room& room)
 
 	// right wall
 	Motion& right_motion = registry.motions.emplace(rightWall);
+	set_collision_layer(right_motion, COLLISION_LAYER::OBSTACLE);
 	right_motion.position = vec2({ x_max, y_mid });
 	right_motion.scale = vec2({ VERTICAL_WALL_BB_HEIGHT, VERTICAL_WALL_BB_WIDTH });
 
@@ -971,6 +1039,7 @@ void createWalls(RenderSystem* render, Room& room)
 			right_wall_texture = TEXTURE_ASSET_ID::RIGHT_LEVEL1_FULL_WALL_OPEN_DOOR;
 			auto right_door = Entity();
 			Motion& right_door_motion = registry.motions.emplace(right_door);
+			set_collision_layer(right_door_motion, COLLISION_LAYER::OBSTACLE);
 			right_door_motion.position = { x_max, y_mid };
 			right_door_motion.scale = { 64,64 };
 			Obstacle& right_door_obstacle = registry.obstacles.emplace(right_door);
@@ -1026,11 +1095,10 @@ void render_room(RenderSystem* render, Level& level, Entity background)
 		//
 		// - larger a -> larger increase of chance per room cleared
 		// - larger b -> smaller increase of chance per room cleared
-		std::knuth_b rnd_engine;
-		std::bernoulli_distribution prob( 1 / (1 + exp(-level.num_shop_spawn_counter + 2.f)) );
+		float shop_probability = 1 / (1 + exp(-level.num_shop_spawn_counter + 2.f));
 		if (level.num_rooms_visited == 1) {
 			world_generator.generateTutorialRoomTwo(current_room, level);
-		} else if (prob(rnd_engine) && level.num_shop_spawned < 1000) {
+		} else if (random_service.chance(RANDOM_STREAM::WORLDGEN, shop_probability) && level.num_shop_spawned < 1000) {
 			// Generate a shop room
 			current_room.room_type = ROOM_TYPE::SHOP_ROOM;
 			world_generator.generateNewRoom(current_room, level);
@@ -1046,10 +1114,7 @@ void render_room(RenderSystem* render, Level& level, Entity background)
 			}
 
 			if (locked_weapons.size() > 0) {
-				std::default_random_engine rng = std::default_random_engine(std::random_device()());
-				std::uniform_int_distribution<int> weapon_idx_selector(0, locked_weapons.size() - 1);
-				
-				current_room.weapon_on_sale = locked_weapons[weapon_idx_selector(rng)];
+				current_room.weapon_on_sale = locked_weapons[random_service.range(RANDOM_STREAM::LOOT, 0, locked_weapons.size() - 1)];
 			} else {
 				current_room.weapon_on_sale = WeaponType::TOTAL_WEAPON_TYPES;
 			}
@@ -1082,6 +1147,8 @@ void render_room(RenderSystem* render, Level& level, Entity background)
 
 	// in case current room was not visited, re-retrieve current room 
 	Room& room_to_render = registry.rooms.get(level.rooms[level.current_room]);
+	// the AIs look up obstacles and line of sight in the grid instead of the position sets
+	room_to_render.build_occupancy();
 
 	float x_origin = (window_width_px / 2) - (game_window_size_px / 2) + 32;
 	float y_origin = (window_height_px / 2) - (game_window_size_px / 2) + 32;
@@ -1110,7 +1177,7 @@ void render_room(RenderSystem* render, Level& level, Entity background)
 			createBoss(render, vec2(x, y), 10000.0f, BossAI::BossState::DEFENSIVE);
 		}
 		else {
-			createEnemy(render, vec2(x, y), 500.0f, enemy_types[rand() % enemy_types.size()], false);
+			createEnemy(render, vec2(x, y), 500.0f, enemy_types[random_service.range(RANDOM_STREAM::WORLDGEN, 0, enemy_types.size() - 1)], false);
 		}
 	}
 
@@ -1130,6 +1197,7 @@ Entity createShopPanel(RenderSystem* renderer, WeaponType weapon_on_sale) {
 	auto entity = Entity();
 
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = { window_width_px / 2, window_height_px / 2 };
 	motion.scale = { game_window_block_size, game_window_block_size };
 
@@ -1202,6 +1270,7 @@ Entity createText(RenderSystem* renderer, std::string content, vec2 pos, float s
 	text.rect_size = getTextRectSize(renderer, content, scale);
 
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = { pos.x, window_height_px - pos.y }; // flip y axis as text is rendered from top to bottom, but we use bottom to top everywhere else
 	motion.scale = vec2({ scale, scale });
 
@@ -1233,8 +1302,10 @@ Entity createMuzzleFlash(RenderSystem* render, Entity source) {
 	auto entity = Entity();
 
 	// Setting initial motion values
-	Motion& source_motion = registry.motions.get(source);
+	// copy, emplacing the new motion can move the source motion
+	Motion source_motion = registry.motions.get(source);
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = source_motion.position + (52.f * vec2{ cos(source_motion.look_angle - M_PI/2), sin(source_motion.look_angle - M_PI/2) });
 	motion.scale = vec2({ 48.f, 48.f });
 	motion.look_angle = source_motion.look_angle - M_PI;
@@ -1270,6 +1341,7 @@ Entity createExplosion(RenderSystem* render, vec2 pos, float scale, bool repeat)
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = pos;
 	motion.scale = vec2({ EXPLOSION_BB_WIDTH * scale, EXPLOSION_BB_HEIGHT * scale });
 
@@ -1301,6 +1373,7 @@ Entity createFire(RenderSystem* render, vec2 pos, float scale, bool repeat)
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = pos;
 	motion.scale = vec2({ FIRE_BB_WIDTH * scale, FIRE_BB_HEIGHT * scale });
 
@@ -1332,6 +1405,7 @@ Entity createBulletImpact(RenderSystem* render, vec2 pos, float scale, bool repe
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = pos;
 	motion.scale = vec2({ BULLET_IMPACT_BB_WIDTH * scale, BULLET_IMPACT_BB_HEIGHT * scale });
 
@@ -1363,6 +1437,7 @@ Entity createWeaponEquippedIcon(RenderSystem* render, vec2 pos, TEXTURE_ASSET_ID
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = pos;
 	motion.scale = vec2({ WEAPON_EQUIPPED_ICON_BB_WIDTH, WEAPON_EQUIPPED_ICON_BB_HEIGHT });
 
@@ -1382,6 +1457,7 @@ Entity createWeaponUnequippedIcon(RenderSystem* render, vec2 pos, TEXTURE_ASSET_
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = pos;
 	motion.scale = vec2({ WEAPON_UNEQUIPPED_ICON_BB_WIDTH, WEAPON_UNEQUIPPED_ICON_BB_HEIGHT });
 
@@ -1401,6 +1477,7 @@ Entity createIconInfinity(RenderSystem* render, vec2 pos)
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = pos;
 	motion.scale = vec2({ ICON_INFINITY_BB_WIDTH, ICON_INFINITY_BB_HEIGHT });
 
@@ -1474,6 +1551,7 @@ Entity createBossProjectile(RenderSystem* render, vec2 position, float angle, fl
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::ENEMY_PROJECTILE);
 	Projectile& projectile = registry.projectiles.emplace(entity);
 	motion.position = position;
 	motion.look_angle = coneAngle;
@@ -1504,6 +1582,7 @@ Entity createBossGuidedMissile(RenderSystem* render, vec2 startPosition, Entity
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::ENEMY_PROJECTILE);
 	Projectile& projectile = registry.projectiles.emplace(entity);
 	projectile.weapon_type = WeaponType::ROCKET_LAUNCHER; // Assume you add this type to your WeaponType enum
 	motion.position = startPosition;
@@ -1548,6 +1627,7 @@ Entity createPowerup(RenderSystem* render, vec2 position)
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::PICKUP);
 	motion.position = position;
 	motion.scale = vec2({ OBSTACLE_BB_WIDTH, OBSTACLE_BB_HEIGHT });
 
@@ -1581,6 +1661,7 @@ Entity createCurrentAmmoIcon(RenderSystem* render, vec2 position, Player& player
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = position;
 	motion.scale = vec2({ CURRENT_AMMO_ICON_BB_WIDTH, CURRENT_AMMO_ICON_BB_HEIGHT });
 
@@ -1642,6 +1723,7 @@ Entity createCursor(RenderSystem* render, vec2 position)
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = position;
 	motion.scale = vec2({ CURSOR_BB_WIDTH, CURSOR_BB_HEIGHT });
 
@@ -1661,6 +1743,7 @@ Entity createMoveTutorialWidget(RenderSystem* render, vec2 position)
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = position;
 	motion.scale = vec2({ TUTORIAL_WIDGET_BB_WIDTH, TUTORIAL_WIDGET_BB_HEIGHT });
 
@@ -1680,6 +1763,7 @@ Entity createAimTutorialWidget(RenderSystem* render, vec2 position)
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = position;
 	motion.scale = vec2({ TUTORIAL_WIDGET_BB_WIDTH, TUTORIAL_WIDGET_BB_HEIGHT });
 
@@ -1699,6 +1783,7 @@ Entity createShootTutorialWidget(RenderSystem* render, vec2 position)
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = position;
 	motion.scale = vec2({ TUTORIAL_WIDGET_BB_WIDTH, TUTORIAL_WIDGET_BB_HEIGHT });
 
@@ -1729,6 +1814,7 @@ Entity createReloadTutorialWidget(RenderSystem* render, vec2 position)
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = position;
 	motion.scale = vec2({ TUTORIAL_WIDGET_BB_WIDTH, TUTORIAL_WIDGET_BB_HEIGHT });
 
@@ -1759,6 +1845,7 @@ Entity createScrollTutorialWidget(RenderSystem* render, vec2 position)
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = position;
 	motion.scale = vec2({ TUTORIAL_WIDGET_BB_WIDTH, TUTORIAL_WIDGET_BB_HEIGHT });
 
@@ -1789,6 +1876,7 @@ Entity createSwitchTutorialWidget(RenderSystem* render, vec2 position)
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = position;
 	motion.scale = vec2({ TUTORIAL_WIDGET_BB_WIDTH, TUTORIAL_WIDGET_BB_HEIGHT });
 
@@ -1819,6 +1907,7 @@ Entity createPowerupPopup(RenderSystem* render, vec2 position)
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = position;
 	motion.scale = vec2({ POWERUP_POPUP_BB_WIDTH, POWERUP_POPUP_BB_HEIGHT });
 
@@ -1849,6 +1938,7 @@ Entity createPowerupIcon(RenderSystem* render, vec2 position, TEXTURE_ASSET_ID p
 
 	// Setting initial motion values
 	Motion& motion = registry.motions.emplace(entity);
+	set_collision_layer(motion, COLLISION_LAYER::UI);
 	motion.position = position;
 	motion.scale = vec2({ POWERUP_ICON_BB_WIDTH, POWERUP_ICON_BB_HEIGHT });
 
@@ -64,6 +64,9 @@ const float POWERUP_ICON_BB_HEIGHT = 64.0f;
 
 const int NUM_ROOMS_UNTIL_BOSS = 4;
 
+// sets the collision layer of the motion and the mask of layers it can collide with
+void set_collision_layer(Motion& motion, unsigned int layer);
+
 // the player
 Entity createPlayer(RenderSystem* renderer, vec2 pos);
 // the enemy
@@ -9,6 +9,9 @@
 #include "menus/shop_menu.hpp"
 #include "components/components.hpp"
 #include "powerup_system/powerup_system.hpp"
+#include "random_service/random_service.hpp"
+#include "profiler/profiler.hpp"
+#include "ai_system/ai_params.hpp"
 
 // stlib
 #include <cassert>
@@ -27,8 +30,6 @@ WorldSystem::WorldSystem()
 {
 	// TODO: world initialization here
 	fullscreen = 0;
-	// Seeding rng with random device
-	rng = std::default_random_engine(std::random_device()());
 }
 
 // Destroy the world
@@ -195,7 +196,7 @@ bool WorldSystem::progress_timers(Player& player, float elapsed_ms_since_last_up
 				}
 				else {
 					// done animating
-					registry.remove_all_components_of(entity);
+					registry.commands.destroy(entity);
 				}
 			}
 			else {
@@ -233,7 +234,7 @@ bool WorldSystem::progress_timers(Player& player, float elapsed_ms_since_last_up
 		// once the timer expired, 50% chance to add or subtract 1 from the multiplier and then restart the timer
 		if (counter.counter_ms < 0) {
 			registry.multiplierBoostPowerupTimers.remove(entity);
-			if (rand() % 2 == 0) {
+			if (random_service.chance(RANDOM_STREAM::LOOT, 0.5f)) {
 				multiplier += .1f;
 			}
 			else {
@@ -264,6 +265,8 @@ bool WorldSystem::progress_timers(Player& player, float elapsed_ms_since_last_up
 // Update our game world
 bool WorldSystem::step(float elapsed_ms_since_last_update) 
 {
+	PROFILE_SCOPE("world.step");
+
 	switch (game_state)
 	{
 	case GAME_STATE::START_MENU:
@@ -307,8 +310,6 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
 		}
 	}
 
-	auto& motions_registry = registry.motions;
-    
 	Player& p = registry.players.get(player);
 	Motion& p_m = registry.motions.get(player);
 
@@ -366,34 +367,29 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
 	}
 
 	// Update HUD
-	ui->update(registry.healths.get(player), registry.shields.get(player), registry.players.get(player), score, multiplier, 0, debugging.show_fps, registry.levels.get(level));
+	ui->update(registry.healths.get(player), registry.shields.get(player), registry.players.get(player), score, multiplier, 0, debugging.show_fps, debugging.show_profiler, registry.levels.get(level));
 	// Update Weapon System
 	weapons->step(elapsed_ms_since_last_update, renderer, player);
 
 	// Removing out of screen entities
-	// Remove entities that leave the screen on the left side
-	// Iterate backwards to be able to remove without unterfering with the next object to visit
-	// (the containers exchange the last element with the current)
-	for (int i = (int)motions_registry.components.size() - 1; i >= 0; --i) {
-		Motion& motion = motions_registry.components[i];
-		Entity& entity = motions_registry.entities[i];
-		if (motion.position.x + abs(motion.scale.x) < 0.f) {
-			if (!registry.players.has(entity)) // don't remove the player
-				registry.remove_all_components_of(entity);
-		}
-
-		if (registry.projectiles.has(entity)) {
-			// max_position from physics_system.cpp and replaced game_window_block_size 
-			// with the entity's width and height
-			float max_position_x = (game_window_size_px / 2) - (motion.scale.x / 2);
-			float max_position_y = (game_window_size_px / 2) - (motion.scale.y / 2);
-			if (
-				abs(motion.position.x - (window_width_px / 2)) >= max_position_x ||
-				abs(motion.position.y - (window_height_px / 2)) >= max_position_y
-			)
-					registry.remove_all_components_of(entity);
-		}
-	}
+	// Remove entities that leave the screen on the left side (don't remove the player)
+	registry.view<Motion>(exclude<Player>).each([](Entity entity, Motion& motion) {
+		if (motion.position.x + abs(motion.scale.x) < 0.f)
+			registry.remove_all_components_of(entity);
+	});
+
+	// Remove projectiles that leave the room
+	registry.projectile_rows.each([](Entity entity, Projectile&, Motion& motion) {
+		// max_position from physics_system.cpp and replaced game_window_block_size 
+		// with the entity's width and height
+		float max_position_x = (game_window_size_px / 2) - (motion.scale.x / 2);
+		float max_position_y = (game_window_size_px / 2) - (motion.scale.y / 2);
+		if (
+			abs(motion.position.x - (window_width_px / 2)) >= max_position_x ||
+			abs(motion.position.y - (window_height_px / 2)) >= max_position_y
+		)
+			registry.commands.destroy(entity);
+	});
 
 	// Progress game timers
 	if (progress_timers(p, elapsed_ms_since_last_update)) { // if the timers returned true, then we should return true early
@@ -521,6 +517,10 @@ void WorldSystem::restart_game() {
 		break;
 
 	case GAME_STATE::GAME: {
+		// every run gets its own seed, derived from the session seed
+		random_service.start_run();
+		printf("Run seed: %llu\n", (unsigned long long)random_service.get_run_seed());
+
 		play_music(game_music);
 
 		glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
@@ -643,29 +643,34 @@ void WorldSystem::enter_room(vec2 player_pos) {
 // Remove entities between rooms
  void WorldSystem::remove_entities_on_entry()
 {
-	for (Entity e : registry.motions.entities)
-	{
-		// remove all enemies, obstacles, animations
-		if (registry.obstacles.has(e) || registry.deadlies.has(e) || registry.tutorialOnlys.has(e) 
-			|| registry.animations.has(e) && !registry.players.has(e) || registry.shopPanels.has(e))
-		{
-			registry.remove_all_components_of(e);
-		}
-	}
-	for (Entity e : registry.onFireTimers.entities)
-	{
-		registry.onFireTimers.remove(e);
-	}
+	// remove all enemies, obstacles, animations
+	for (Entity e : registry.view<Motion, Obstacle>())
+		registry.remove_all_components_of(e);
+	for (Entity e : registry.view<Motion, Deadly>())
+		registry.remove_all_components_of(e);
+	for (Entity e : registry.view<Motion, TutorialOnly>())
+		registry.remove_all_components_of(e);
+	for (Entity e : registry.view<Motion, Animation>(exclude<Player>))
+		registry.remove_all_components_of(e);
+	for (Entity e : registry.view<Motion, ShopPanel>())
+		registry.remove_all_components_of(e);
+	registry.onFireTimers.clear();
 }
 // Compute collisions between entities
 void WorldSystem::handle_collisions(float elapsed_ms) {
+	PROFILE_SCOPE("world.handle_collisions");
+
 	// Loop over all collisions detected by the physics system
 	auto& collisionsRegistry = registry.collisions;
 	for (uint i = 0; i < collisionsRegistry.components.size(); i++) {
 		// The entity and its collider
 		Entity entity = collisionsRegistry.entities[i];
 		Entity entity_other = collisionsRegistry.components[i].other;
-		float scalar = collisionsRegistry.components[i].scalar;
+		const Collision& collision = collisionsRegistry.components[i];
+
+		// destroys are deferred until the loop is done, skip what was already destroyed by an earlier collision
+		if (registry.commands.is_destroyed(entity) || registry.commands.is_destroyed(entity_other))
+			continue;
 	
 		if (registry.players.has(entity) && registry.obstacles.has(entity_other)) {
 			
@@ -778,21 +783,21 @@ void WorldSystem::handle_collisions(float elapsed_ms) {
 			}
 			else if (registry.powerups.has(entity_other)) {
 				// player collided with a powerup
-				registry.remove_all_components_of(entity_other);
+				registry.commands.destroy(entity_other);
 				assert(registry.players.has(entity) && "Entity should be a player");
-				powerups->awardPowerup(entity, rng, uniform_dist);
+				powerups->awardPowerup(entity);
 			}
 			else {
-				bounce_back(player, entity_other);
+				bounce_back(entity, collision);
 			}
 		}
 
-		//if obstacle and enemies collide, enemy moves perpendicularly to the obstacle
-		else if (registry.obstacles.has(entity) && registry.ais.has(entity_other)) {
-			Motion& obs_motion = registry.motions.get(entity_other);
+		//if obstacle and enemies collide, the enemy is pushed out of the obstacle
+		//(the record with the enemy first, so the translation of the collision applies to the enemy)
+		else if (registry.ais.has(entity) && registry.obstacles.has(entity_other)) {
 			if ((!registry.bosses.has(entity)) && (!registry.bosses.has(entity_other))) {
 				// collission between non-bosses
-				bounce_back(entity_other, entity);
+				bounce_back(entity, collision);
 			}
 		}
 		//Player projectile to boss
@@ -823,7 +828,8 @@ void WorldSystem::handle_collisions(float elapsed_ms) {
 							createBulletImpact(renderer, registry.motions.get(entity).position, 1.0, false);
 						}
 					}
-					registry.remove_all_components_of(entity); // Remove projectile after collision
+					registry.commands.destroy(entity); // Remove projectile after collision
+					continue;
 				}
 			}
 		}
@@ -837,8 +843,9 @@ void WorldSystem::handle_collisions(float elapsed_ms) {
 				createBulletImpact(renderer, registry.motions.get(entity).position, 1.0, false);
 				createExplosion(renderer, registry.motions.get(entity_other).position, 1.0, false);
 				play_sound(explosion_sound);
-				registry.remove_all_components_of(entity); // Remove projectile after collision
-				registry.remove_all_components_of(entity_other); // Remove projectile after collision
+				registry.commands.destroy(entity); // Remove projectile after collision
+				registry.commands.destroy(entity_other); // Remove projectile after collision
+				continue;
 			}
 		}
 		// PROJECTILE COLLISONS player to ais
@@ -874,7 +881,7 @@ void WorldSystem::handle_collisions(float elapsed_ms) {
 						createBulletImpact(renderer, registry.motions.get(entity).position, 1.0, false);
 					}
 				}
-				registry.remove_all_components_of(entity); // Remove projectile after collision
+				registry.commands.destroy(entity); // Remove projectile after collision
 			}
 
 			// Collision logic for enemy projectiles hitting the player
@@ -939,7 +946,7 @@ void WorldSystem::handle_collisions(float elapsed_ms) {
 						createBulletImpact(renderer, registry.motions.get(entity).position, 1.0, false);
 					}
 				}
-				registry.remove_all_components_of(entity); // Remove projectile after collision
+				registry.commands.destroy(entity); // Remove projectile after collision
 			}
 			// Collision logic for boss projectile hitting player
 			else if (registry.bosses.has(projectileSource) && registry.players.has(entity_other)) {
@@ -990,7 +997,7 @@ void WorldSystem::handle_collisions(float elapsed_ms) {
 					}
 
 				}
-				registry.remove_all_components_of(entity); // Remove projectile after collision
+				registry.commands.destroy(entity); // Remove projectile after collision
 			}
 
 
@@ -1011,7 +1018,7 @@ void WorldSystem::handle_collisions(float elapsed_ms) {
 				}
 				if (projectile.source != entity_other && !registry.noCollisionChecks.has(entity_other)) {
 					// Remove the projectile, it hit an obstacle
-					registry.remove_all_components_of(entity);
+					registry.commands.destroy(entity);
 				}
 			}		
 
@@ -1022,14 +1029,17 @@ void WorldSystem::handle_collisions(float elapsed_ms) {
 
 				if (registry.players.has(projectile.source) && registry.ais.has(projectile_other.source)) {
 					if (projectile.weapon_type == WeaponType::ENERGY_HALO) {
-						registry.remove_all_components_of(entity);
-						registry.remove_all_components_of(entity_other);
+						registry.commands.destroy(entity);
+						registry.commands.destroy(entity_other);
 					}
 				}
 			}
 		}
 	}
 
+	// sync point, the dead enemy checks below see the projectiles and pickups removed above
+	registry.flush_commands();
+
 	// Check for dead enemies
 	for (Entity e : registry.ais.entities) {
 		vec2 e_pos = registry.motions.get(e).position;
@@ -1039,15 +1049,14 @@ void WorldSystem::handle_collisions(float elapsed_ms) {
 
 			// remove the fire effect if an enemy dies
 			if (registry.onFireTimers.has(e)) {
-				registry.remove_all_components_of(registry.onFireTimers.get(e).fire);
+				registry.commands.destroy(registry.onFireTimers.get(e).fire);
 			}
-			Motion& motion = registry.motions.get(e);
-			vec2 pos = motion.position;
-			registry.remove_all_components_of(e);
+			vec2 pos = registry.motions.get(e).position;
+			// destroyed at the sync point after the loops, removing now would skip the next enemy
+			registry.commands.destroy(e);
 
 			// roll 10% chance to spawn a powerup
-			std::uniform_int_distribution<int> powerup_dist(0, 9);
-			if (powerup_dist(rng) == 0) {
+			if (random_service.range(RANDOM_STREAM::LOOT, 0, 9) == 0) {
 				// spawn a powerup
 				// TODO: Play sound effect for powerup spawn
 				if (registry.powerupPopUps.has(player)) {
@@ -1099,9 +1108,9 @@ void WorldSystem::handle_collisions(float elapsed_ms) {
 				boss.aliveEnemyCount = std::max(0, boss.aliveEnemyCount - 1); // Decrement and ensure it doesn't go below 0
 				// remove the fire effect if an enemy diesa
 				if (registry.onFireTimers.has(e)) {
-					registry.remove_all_components_of(registry.onFireTimers.get(e).fire);
+					registry.commands.destroy(registry.onFireTimers.get(e).fire);
 				}
-				registry.remove_all_components_of(e);
+				registry.commands.destroy(e);
 				score++;
 			
 				// UX Effects
@@ -1112,9 +1121,9 @@ void WorldSystem::handle_collisions(float elapsed_ms) {
 		if (boss_health.current_health <= 0 ) {
 			registry.remove_all_components_of(boss_e);
 			score += 1000;
-			if (!registry.deathTimers.has(boss_e)) {
-				registry.deathTimers.emplace(boss_e);
-			}
+			// boss_e is destroyed above, the win countdown gets its own entity
+			Entity win_timer;
+			registry.deathTimers.emplace(win_timer);
 			//stop motion for all ais 
 			for (Entity e : registry.ais.entities) {
 				Motion& motion = registry.motions.get(e);
@@ -1123,7 +1132,10 @@ void WorldSystem::handle_collisions(float elapsed_ms) {
 				motion.is_moving_down = false;
 				motion.is_moving_left = false;
 				motion.is_moving_right = false;
-				registry.remove_all_components_of(e);
+				if (registry.onFireTimers.has(e)) {
+					registry.commands.destroy(registry.onFireTimers.get(e).fire);
+				}
+				registry.commands.destroy(e);
 			}
 			// stop motion for player
 			Motion& player_motion = registry.motions.get(player);
@@ -1138,6 +1150,8 @@ void WorldSystem::handle_collisions(float elapsed_ms) {
 			
 		}
 	}
+	// sync point, the enemies killed above leave the registry together
+	registry.flush_commands();
 
 	// Remove all collisions from this simulation step
 	registry.collisions.clear();
@@ -1150,8 +1164,12 @@ bool WorldSystem::is_over() const {
 }
 
 // On key callback
-void WorldSystem::on_key(int key, int, int action, int mod) 
+void WorldSystem::on_key(int key, int scancode, int action, int mod) 
 {
+	if (recorder) {
+		recorder->key(key, scancode, action, mod);
+	}
+
 	// key is of 'type' GLFW_KEY_
 	// action can be GLFW_PRESS GLFW_RELEASE GLFW_REPEAT
 
@@ -1268,6 +1286,17 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 		if (action == GLFW_RELEASE && key == GLFW_KEY_F) {
 			debugging.show_fps = !debugging.show_fps;
 		}
+
+		// Profiler overlay
+		if (action == GLFW_RELEASE && key == GLFW_KEY_P) {
+			debugging.show_profiler = !debugging.show_profiler;
+		}
+
+		// Reload the AI tuning from data/ai_params.txt, not in recorded sessions as the file is not part of the log
+		if (action == GLFW_RELEASE && key == GLFW_KEY_L && !recorder && !replaying) {
+			if (load_ai_params(ai_params_path()))
+				std::cout << "Reloaded " << ai_params_path() << std::endl;
+		}
 		//full screen mode
 
 		// Player keyboard controls
@@ -1432,70 +1461,41 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 
 }
 
-void WorldSystem::bounce_back(Entity player, Entity obstacle) {
-	// Bounce back functionality by moving back by a bit
-	//Motion& playerMotion = registry.motions.get(player);
-	//playerMotion.velocity *= -1;
-	//playerMotion.position += playerMotion.velocity * 0.01f;
-	if (registry.immobiles.has(player)) {
+void WorldSystem::bounce_back(Entity entity, const Collision& collision) {
+	if (registry.immobiles.has(entity)) {
 		return; // do not move immobile entities
 	}
 
-	Motion& p_motion = registry.motions.get(player);
-	Motion& obs_motion = registry.motions.get(obstacle);
+	Motion& motion = registry.motions.get(entity);
 
-	vec2& p_pos = p_motion.previous_position;
-	vec2& p_size = p_motion.scale;
-	vec2& obs_pos = obs_motion.position;
-	vec2& obs_size = obs_motion.scale;
-
-	float p_minx = p_pos.x - p_size.x / 2;
-	float p_maxx = p_pos.x + p_size.x / 2;
-	float p_miny = p_pos.y + p_size.y / 2;
-	float p_maxy = p_pos.y - p_size.y / 2;
-	
-	float obs_left = obs_pos.x - obs_size.x / 2;
-	float obs_right = obs_pos.x + obs_size.x / 2;
-	float obs_bottom = obs_pos.y + obs_size.y / 2;
-	float obs_top = obs_pos.y - obs_size.y / 2;
-	
-	float angle = atan2(obs_pos.y - p_pos.y, obs_pos.x - p_pos.x);
-	float top_left_angle = atan2(obs_pos.y - obs_top, obs_pos.x - obs_left);
-	float top_right_angle = atan2(obs_pos.y - obs_top, obs_pos.x - obs_right);
-	float bottom_right_angle = atan2(obs_pos.y - obs_bottom, obs_pos.x - obs_right);
-	float bottom_left_angle = atan2(obs_pos.y - obs_bottom, obs_pos.x - obs_left);
-	
-	// Check if player travels upwards
-	if (angle >= bottom_right_angle && angle < bottom_left_angle) {
-		p_motion.position.y = obs_bottom + p_size.y / 2;
-		p_motion.velocity.y = 0;
-	}
-	// Check if player travels downwards
-	else if (angle >= top_left_angle && angle < top_right_angle) {
-		p_motion.position.y = obs_top - p_size.y / 2;
-		p_motion.velocity.y = 0;
+	// Move out along the minimum translation vector of the collision, minus what earlier
+	// collisions of this step already moved the entity that way (e.g. two adjacent obstacles)
+	float resolved = dot(motion.position - collision.position, collision.normal);
+	float remaining = collision.depth - resolved;
+	if (remaining > 0.f) {
+		motion.position += collision.normal * remaining;
 	}
-	// Check if player travels rightwards
-	else if (angle >= bottom_left_angle && angle < top_left_angle) {	
-		p_motion.position.x = obs_left - p_size.x / 2;
-		p_motion.velocity.x = 0;
-	}
-	// Check if player travels leftwards
-	else if (angle >= top_right_angle || angle < bottom_right_angle) {
-		p_motion.position.x = obs_right + p_size.x / 2;
-		p_motion.velocity.x = 0;
+
+	// Stop the part of the velocity that goes into the obstacle, so the entity slides along it
+	float into = dot(motion.velocity, collision.normal);
+	if (into < 0.f) {
+		motion.velocity -= collision.normal * into;
 	}
 }
 
 void WorldSystem::on_mouse_move(vec2 mouse_position) 
 {
+	if (recorder) {
+		recorder->mouse_move(mouse_position);
+	}
+
 	int cursor_;
 
 	switch (game_state) 
 	{
 	case GAME_STATE::START_MENU:
 		break;
-	case GAME_STATE::GAME:
+	case GAME_STATE::GAME: {
 		if (!registry.motions.has(cursor)) {
 			cursor = createCursor(renderer, mouse_position);
 		} else {
@@ -1509,6 +1509,7 @@ void WorldSystem::on_mouse_move(vec2 mouse_position)
 		vec2 direction = mouse_position - player_position;
 		registry.motions.get(player).look_angle = atan2(direction.y, direction.x) + M_PI/2;
 		break;
+	}
 	
 	case GAME_STATE::PAUSE_MENU:
 		/*PauseMenu::has_state_changed = false;
@@ -1578,6 +1579,10 @@ void WorldSystem::on_mouse_move(vec2 mouse_position)
 }
 
 void WorldSystem::on_scroll(double x_offset, double y_offset) {
+	if (recorder) {
+		recorder->scroll(x_offset, y_offset);
+	}
+
 	switch (game_state) {
 		case GAME_STATE::GAME:
 			if (y_offset > 0) {
@@ -1599,6 +1604,10 @@ void WorldSystem::on_scroll(double x_offset, double y_offset) {
 
 void WorldSystem::on_mouse_click(int button, int action, int mods) 
 {
+	if (recorder) {
+		recorder->mouse_click(button, action, mods);
+	}
+
 	// glfw mouse button codes
 	int left_click = 0;
 	int right_click = 1;
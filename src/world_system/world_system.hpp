@@ -7,10 +7,10 @@
 #include "ui_system/ui_system.hpp"
 #include "weapon_system/weapon_system.hpp"
 #include "powerup_system/powerup_system.hpp"
+#include "replay/input_log.hpp"
 
 // stlib
 #include <vector>
-#include <random>
 
 // Container for all our entities and game logic. Individual rendering / update is
 // deferred to the relative update() methods
@@ -42,13 +42,6 @@ class WorldSystem
 //	// Should the game be over ?
 //	bool is_over()const;
 private:
-	// Input callback functions
-	void on_key(int key, int, int action, int mod);
-	void on_scroll(double x_offset, double y_offset);
-	void on_mouse_move(vec2 pos);
-	void on_mouse_click(int button, int action, int mod);
-
-
 	// restart level
 	void restart_game();
 
@@ -60,7 +53,7 @@ private:
 	bool progress_timers(Player& player, float elapsed_ms_since_last_update);
 
 	// OpenGL window handle
-	GLFWwindow* window;
+	GLFWwindow* window = nullptr;
 	Entity cursor; // custom cursor
 
 	// Game state
@@ -98,10 +91,6 @@ private:
 	float multiplier; // Min 0.0, Max 9.9
 	int delta_score; // Score gained in the current period TBD what a period is
 
-	// C++ random number generator
-	std::default_random_engine rng;
-	std::uniform_real_distribution<float> uniform_dist; // number between 0..1
-
 
 public:
 	WorldSystem();
@@ -114,6 +103,17 @@ public:
 	// starts the game
 	void init(RenderSystem* renderer_arg, UISystem* ui_arg, WeaponSystem* weapon_arg, PowerupSystem* powerups_arg);
 
+	// Input callback functions, called by GLFW or by the scripted input of the headless runner
+	void on_key(int key, int, int action, int mod);
+	void on_scroll(double x_offset, double y_offset);
+	void on_mouse_move(vec2 pos);
+	void on_mouse_click(int button, int action, int mod);
+
+	// when set, every input event is recorded for a later replay
+	InputRecorder* recorder = nullptr;
+	// set while a recording drives the input
+	bool replaying = false;
+
 	// Releases all associated resources
 	~WorldSystem();
 
@@ -124,7 +124,8 @@ public:
 	// Check for collisions
 	void handle_collisions(float elapsed_ms);
 
-	void bounce_back(Entity player, Entity obstacle);
+	// Push the first entity of the collision out of the other one
+	void bounce_back(Entity entity, const Collision& collision);
 
 	// Should the game be over ?
 	bool is_over()const;